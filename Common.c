@@ -5,14 +5,14 @@
  * Date         : 31/10/2025
  *
  * Description  : This file contains common helper functions used across all arithmetic modules of the APC project.
- *                It provides argument validation, string-to-list conversion, linked list operations, comparison logic,
- *                and formatted output routines. These functions serve as the fundamental building blocks for handling
- *                arbitrary-length integer operations.
+ *                It provides argument validation, string-to-number conversion, limb array storage management, comparison
+ *                logic, and formatted output routines. These functions serve as the fundamental building blocks for
+ *                handling arbitrary-length integer operations.
  *
  * Core Functionalities:
  *                1. Command-line argument validation and parsing.
- *                2. String-to-doubly-linked-list number conversion.
- *                3. Linked list operations — insertion, deletion, copying, and comparison.
+ *                2. Decimal string ↔ base 2^32 limb array conversion (nine decimal digits per step).
+ *                3. Number storage operations — allocation, growth, trimming, copying, and comparison.
  *                4. Numeric validation for input strings.
  *                5. Even/odd exponent check for power computation.
  *                6. Formatted printing of calculations with right-aligned results.
@@ -20,13 +20,19 @@
  * Major Functions:
  *                • Validate_arguments()  → Verifies correct number and format of command-line arguments.
  *                • isNumeric()           → Checks if a given string represents a valid integer.
- *                • String_to_list()      → Converts a numeric string into a doubly linked list of digits.
- *                • Find_largest()        → Compares two number lists and identifies the larger one.
- *                • insert_at_first() / 
- *                  insert_at_last()      → Insert digit nodes at respective ends of a list.
- *                • delete_at_first()     → Removes leading zeros from a result list.
+ *                • String_to_number()    → Converts a numeric string into a packed limb array (via convert.c).
+ *                • Number_to_string()    → Converts a packed limb array back into decimal text (via convert.c).
+ *                • Find_largest()        → Compares two numbers and identifies the larger one.
+ *                • reserve_number()      → Grows the limb array of a number to a requested capacity.
+ *                • trim_number()         → Removes leading zero limbs from a result.
+ *                • shift_number_up() /
+ *                  shift_number_down()   → Multiply / floor-divide a number by a power of the limb base.
  *                • is_exp_even()         → Determines whether an exponent is even or odd.
+ *                • compare_limbs() /
+ *                  lshift_limbs() /
+ *                  rshift_limbs()        → Raw limb kernels used by the multiplication and division algorithms.
  *                • print_calculation()   → Displays formatted arithmetic operation output.
+ *                • print_raw()           → Writes only the signed result digits, straight to a file descriptor.
  *
  * Notes         :
  *                • All operations in this file work on magnitudes only — sign management is done in main().
@@ -39,22 +45,40 @@
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
+#include <errno.h>
+#include <unistd.h>
 
 static const char* operators = "+-x^/%";
 
+/* Operand token: a number, or "@path" naming a file whose contents are checked when it is loaded */
+static int is_operand( const char *str )
+{
+    if( str[0] == '@' )
+        return str[1] ? NUMERIC : NON_NUMERIC;
+
+    return isNumeric( str );
+}
+
 /* Validate all arguments */
 int Validate_arguments( int argc, char* argv[] )
 {
-    if( argc != 4 )
+    if( argc != 4 && argc != 6 )
         return FAILURE;
 
     if( strchr( operators, argv[2][0] ) == NULL || argv[2][1] != '\0' )
         return FAILURE;
+
+    // Modular power: <base> ^ <exponent> % <modulus>
+    if( argc == 6 )
+    {
+        if( strcmp( argv[2], "^" ) != 0 || strcmp( argv[4], "%" ) != 0 || is_operand( argv[5] ) == NON_NUMERIC )
+            return FAILURE;
+    }
     
     char* str1 = argv[1];
     char* str2 = argv[3];
 
-    if( isNumeric( str1 ) == NON_NUMERIC || isNumeric( str2 ) == NON_NUMERIC )
+    if( is_operand( str1 ) == NON_NUMERIC || is_operand( str2 ) == NON_NUMERIC )
         return FAILURE;
 
     return SUCCESS;
@@ -63,171 +87,260 @@ int Validate_arguments( int argc, char* argv[] )
 /* Validate if CLA 2 and 4 are numeric */
 int isNumeric(const char *str)
 {
-    int i = 0;
-
     if( str[0] == '+' || str[0] == '-' )
-        i = 1;
+        str++;
 
-    for( ; str[i] != '\0'; i++)
-    {
-        if( !isdigit( str[i] ))
-            return NON_NUMERIC;   // False
-    }
+    // Word-at-a-time scan shared with file operands (operand.c)
+    return check_digits( str, strlen( str ) );
+}
 
-    return NUMERIC;   // True
+
+/* Convert the string argument to a number */
+Status String_to_number( Bignum *num, const char *str )
+{
+    // Sign is handled by the caller
+    if( str[0] == '+' || str[0] == '-' )
+        str++;
+
+    return decimal_to_number( num, str, strlen( str ) );
 }
 
-/* Covert the string argument to lists */
-void String_to_list( Dlist **head, Dlist **tail, const char *str )
+/* Convert a number to a freshly allocated decimal string */
+char *Number_to_string( const Bignum *num )
 {
-    int i = 0;
+    // Upper bound on the digit count: bits × log10(2), plus rounding headroom
+    size_t width = (size_t) ( (double) num -> len * LIMB_BITS * 0.30102999566398120 ) + 2;
 
-    if( str[0] == '+' || str[0] == '-' )
+    char *str = malloc( width + 1 );
+    if( str == NULL )
     {
-        i = 1;
+        perror("INFO : Memory Allocation Failed");
+        return NULL;
     }
 
-    for( ; str[i] != '\0'; i++ )
+    if( number_to_decimal( num, str, width ) != SUCCESS )
     {
-        if( insert_at_last( head, tail, str[i] - '0' ) != SUCCESS )
-        {
-            printf("INFO : Insertion Failure");
-            exit(1);
-        }
+        free( str );
+        return NULL;
     }
+
+    // Drop the zero padding, keeping at least one digit
+    size_t lead = 0;
+    while( lead < width - 1 && str[lead] == '0' )
+        lead++;
+
+    memmove( str, str + lead, width - lead );
+    str[ width - lead ] = '\0';
+
+    return str;
 }
 
-// To find largest among 2 number lists
-Status Find_largest( Dlist *head1, Dlist *head2 )
+// To find largest among 2 numbers
+Status Find_largest( const Bignum *num1, const Bignum *num2 )
 {
-	int len1 = 0, len2 = 0;
-	Dlist *temp1 = head1, *temp2 = head2;
-
 	// Case 1: Using length of numbers
-	while( temp1 ) { len1++; temp1 = temp1 -> next; }
-	while( temp2 ) { len2++; temp2 = temp2 -> next; }
-
-	if( len1 > len2 ) return LARGE_1;
-	if( len2 > len1 ) return LARGE_2;
+	if( num1 -> len > num2 -> len ) return LARGE_1;
+	if( num2 -> len > num1 -> len ) return LARGE_2;
 
-	// Case 2: Length is equal, check digit wise
-	temp1 = head1, temp2 = head2;
-	while( temp1 && temp2 )
+	// Case 2: Length is equal, check limb wise from the most significant end
+	for( size_t i = num1 -> len; i-- > 0; )
 	{
-		if( temp1 -> data > temp2 -> data ) return LARGE_1;
-		if( temp1 -> data < temp2 -> data ) return LARGE_2;
-
-		temp1 = temp1 -> next;
-		temp2 = temp2 -> next;
+		if( num1 -> limbs[i] > num2 -> limbs[i] ) return LARGE_1;
+		if( num1 -> limbs[i] < num2 -> limbs[i] ) return LARGE_2;
 	}
 
 	// Case 3: Numbers are equal
 	return EQUAL;
 }
 
-// Inert a new node at the end of lists
-Status insert_at_last( Dlist **head, Dlist **tail, int digit )
+// Initialise an empty number (value zero, nothing allocated)
+void init_number( Bignum *num )
+{
+    num -> limbs = NULL;
+    num -> len = 0;
+    num -> cap = 0;
+}
+
+// Make sure the number can hold at least cap limbs, keeping its value
+Status reserve_number( Bignum *num, size_t cap )
 {
-    Dlist *new = malloc( sizeof( Dlist ));
+    if( cap <= num -> cap )
+        return SUCCESS;
+
+    // Grow geometrically so repeated small growth stays amortised O(1)
+    size_t new_cap = num -> cap * 2;
+    if( new_cap < cap )
+        new_cap = cap;
+
+    limb_t *new = apc_realloc( num -> limbs, new_cap * sizeof( limb_t ) );
     if( new == NULL )
     {
         perror("INFO : Memory Allocation Failed");
         return FAILURE;
     }
 
-    new -> data = digit;
-    new -> next = NULL;
-    new -> prev = NULL;
+    num -> limbs = new;
+    num -> cap = new_cap;
 
-    if( *head == NULL )
-    {
-        *head = new;
-        *tail = new;
+    return SUCCESS;
+}
 
+// Remove the leading zero limbs of a number
+void trim_number( Bignum *num )
+{
+    while( num -> len && num -> limbs[ num -> len - 1 ] == 0 )
+        num -> len--;
+}
+
+// Release the limb array of a number and reset it to zero
+void free_number( Bignum *num )
+{
+    apc_free( num -> limbs );
+    init_number( num );
+}
+
+// Copy the value of src into dst
+Status copy_number( const Bignum *src, Bignum *dst )
+{
+    if( src == dst )
         return SUCCESS;
-    }
 
-    (*tail) -> next = new;
-    new -> prev = *tail;
-    *tail = new;
-    
+    if( reserve_number( dst, src -> len ) != SUCCESS )
+        return FAILURE;
+
+    if( src -> len )
+        memcpy( dst -> limbs, src -> limbs, src -> len * sizeof( limb_t ) );
+    dst -> len = src -> len;
+
     return SUCCESS;
 }
 
-// Insert a new node at the start of lists
-Status insert_at_first( Dlist **head, Dlist **tail, int digit )
+// Set a number to a single word value
+Status set_number_word( Bignum *num, limb_t value )
 {
-    Dlist *new = malloc( sizeof( Dlist ) );
-    if( new == NULL )
+    num -> len = 0;
+    if( value == 0 )
+        return SUCCESS;
+
+    if( reserve_number( num, 1 ) != SUCCESS )
         return FAILURE;
-    
-    new -> data = digit;
-    new -> next = NULL;
-    new -> prev = NULL;
 
-    if( *tail == NULL )
+    num -> limbs[0] = value;
+    num -> len = 1;
+
+    return SUCCESS;
+}
+
+/* Limb kernel: compare two n-limb magnitudes, returns LARGE_1, LARGE_2 or EQUAL */
+Status compare_limbs( const limb_t *a, const limb_t *b, size_t n )
+{
+    while( n-- > 0 )
     {
-        *tail = new;
-        *head = new;
+        if( a[n] != b[n] )
+            return a[n] > b[n] ? LARGE_1 : LARGE_2;
+    }
 
-        return SUCCESS;
+    return EQUAL;
+}
+
+/* Limb kernel: r[0..n) = a << shift for 0 < shift < LIMB_BITS, returns the bits shifted out. r may alias a. */
+limb_t lshift_limbs( limb_t *r, const limb_t *a, size_t n, unsigned shift )
+{
+    limb_t out = 0;
+
+    // Walk from the top so that r == a is safe
+    for( size_t i = n; i-- > 0; )
+    {
+        limb_t cur = a[i];
+        if( i == n - 1 )
+            out = cur >> ( LIMB_BITS - shift );
+        r[i] = ( cur << shift ) | ( i ? a[i - 1] >> ( LIMB_BITS - shift ) : 0 );
     }
 
-    (*head) -> prev = new;
-    new -> next = *head;
-    *head = new;
+    return out;
+}
 
-    return SUCCESS;
+/* Limb kernel: r[0..n) = a >> shift for 0 < shift < LIMB_BITS, returns the bits shifted out (in the high end). r may alias a. */
+limb_t rshift_limbs( limb_t *r, const limb_t *a, size_t n, unsigned shift )
+{
+    limb_t out = n ? a[0] << ( LIMB_BITS - shift ) : 0;
+
+    // Walk from the bottom so that r == a is safe
+    for( size_t i = 0; i < n; i++ )
+        r[i] = ( a[i] >> shift ) | ( i + 1 < n ? a[i + 1] << ( LIMB_BITS - shift ) : 0 );
+
+    return out;
 }
 
-// Delete the first node of a list
-Status delete_at_first( Dlist **headR, Dlist **tailR )
+/* num = num · B^k */
+Status shift_number_up( Bignum *num, size_t k )
 {
-    if( *headR == NULL || *headR == *tailR )
+    if( num -> len == 0 || k == 0 )
         return SUCCESS;
 
-    while( (*headR) != *tailR && (*headR) -> data == 0 )
+    if( reserve_number( num, num -> len + k ) != SUCCESS )
+        return FAILURE;
+
+    memmove( num -> limbs + k, num -> limbs, num -> len * sizeof( limb_t ) );
+    memset( num -> limbs, 0, k * sizeof( limb_t ) );
+    num -> len += k;
+
+    return SUCCESS;
+}
+
+/* num = floor( num / B^k ) */
+void shift_number_down( Bignum *num, size_t k )
+{
+    if( k >= num -> len )
     {
-        Dlist* temp = *headR;
-        *headR = (*headR) -> next;
-        (*headR) -> prev = NULL;
-        free( temp );
+        num -> len = 0;
+        return;
     }
 
+    memmove( num -> limbs, num -> limbs + k, ( num -> len - k ) * sizeof( limb_t ) );
+    num -> len -= k;
+}
+
+/* num = B^k */
+Status set_base_power( Bignum *num, size_t k )
+{
+    if( reserve_number( num, k + 1 ) != SUCCESS )
+        return FAILURE;
+
+    memset( num -> limbs, 0, k * sizeof( limb_t ) );
+    num -> limbs[k] = 1;
+    num -> len = k + 1;
+
     return SUCCESS;
 }
 
 // Check if the exponent is even
-Status is_exp_even( Dlist *expH )
+Status is_exp_even( const Bignum *exp )
 {
-    Dlist *temp = expH;
-    while( temp -> next )
-        temp = temp -> next;
-
-    if( ( temp -> data % 2 ) == 0 )
+    if( exp -> len == 0 || ( exp -> limbs[0] % 2 ) == 0 )
         return EVEN;
     else
         return ODD;
 }
 
 // Print the result in formated way and the final sign
-void print_calculation( char *num1, char op, char *num2, Dlist *headR, char* final_sign )
+void print_calculation( char *num1, char op, char *num2, char *num3, const Bignum *result, char* final_sign )
 {
     int len1 = strlen(num1);
     int len2 = strlen(num2);
+    int len3 = num3 ? (int) strlen(num3) : 0;
 
-    // Count digits in result
-    int lenR = 0;
-    Dlist *temp = headR;
-    while (temp)
-    {
-        lenR++;
-        temp = temp -> next;
-    }
+    // Convert the result to decimal digits
+    char *digits = Number_to_string( result );
+    if( digits == NULL )
+        return;
+
+    int lenR = strlen( digits );
 
     // Find max width for alignment
     int width = len1;
     if ( len2 > width ) width = len2;
+    if ( len3 > width ) width = len3;
     if ( lenR > width ) width = lenR;
 
     // Print num1
@@ -236,6 +349,10 @@ void print_calculation( char *num1, char op, char *num2, Dlist *headR, char* fin
     // Print operator left, num2 right aligned
     printf("%c %*s\n", op, width + 1, num2);
 
+    // Modular power: modulus on its own line
+    if( num3 )
+        printf("%% %*s\n", width + 1, num3);
+
     // Print line seperation
     printf(" ");
     for( int i = 0; i <= width + 1; i++ )
@@ -246,10 +363,11 @@ void print_calculation( char *num1, char op, char *num2, Dlist *headR, char* fin
     printf("= ");
 
     // Handle zero alignment separately
-    if ( headR && headR -> data == 0 && headR -> next == NULL )
+    if ( result -> len == 0 )
     {
         // result is exactly 0 -> align it to the right edge
         printf("%*c\n", width + 1, '0');
+        free( digits );
         return;
     }
 
@@ -259,12 +377,55 @@ void print_calculation( char *num1, char op, char *num2, Dlist *headR, char* fin
     else
         printf(" ");
 
-    // Print result (digits from head)
-    temp = headR;
-    while ( temp )
+    // Print result digits
+    printf("%s\n", digits);
+    free( digits );
+}
+
+/* Raw output: the signed result and a newline, written to fd in large write() calls without any layout */
+Status print_raw( int fd, const Bignum *result, char final_sign )
+{
+    size_t width = (size_t) ( (double) result -> len * LIMB_BITS * 0.30102999566398120 ) + 2;
+
+    // One spare byte in front for the sign and one behind for the newline, so the digits are never copied
+    char *buf = malloc( width + 2 );
+    if( buf == NULL )
     {
-        printf("%d", temp->data);
-        temp = temp->next;
+        perror("INFO : Memory Allocation Failed");
+        return FAILURE;
     }
-    printf("\n");
+
+    if( number_to_decimal( result, buf + 1, width ) != SUCCESS )
+    {
+        free( buf );
+        return FAILURE;
+    }
+
+    char *p = buf + 1;
+    while( p < buf + width && *p == '0' )
+        p++;
+
+    if( final_sign == '-' && result -> len )
+        *--p = '-';
+    buf[ width + 1 ] = '\n';
+
+    // write() may take less than asked for (pipes, signals), keep going until everything is out
+    size_t left = (size_t) ( buf + width + 2 - p );
+    while( left )
+    {
+        ssize_t n = write( fd, p, left < RAW_WRITE_CHUNK ? left : RAW_WRITE_CHUNK );
+        if( n < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+            free( buf );
+            return FAILURE;
+        }
+
+        p += n;
+        left -= (size_t) n;
+    }
+
+    free( buf );
+    return SUCCESS;
 }
\ No newline at end of file
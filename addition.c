@@ -1,71 +1,149 @@
 /*******************************************************************************************************************************************************************
  * Function Name    : addition
- * Description      : Performs addition of two large positive numbers represented as doubly linked lists. Each node stores a 
- *                    single digit, where the head represents the Most Significant Digit (MSD) and the tail represents the 
- *                    Least Significant Digit (LSD). The function adds digits from right to left (LSD to MSD), manages carry 
- *                    propagation, and constructs the result in a separate doubly linked list.
+ * Description      : Performs addition of two large positive numbers represented as packed limb arrays. Each limb stores a 
+ *                    base 2^32 digit, with index 0 holding the Least Significant Limb. The function adds limbs from the 
+ *                    least significant end upwards, manages carry propagation, and writes the sum into a separate number.
  *
- * Prototype        : Status addition( Dlist **head1, Dlist **tail1,
- *                                     Dlist **head2, Dlist **tail2,
- *                                     Dlist **headR, Dlist **tailR );
+ * Prototype        : Status addition( const Bignum *num1, const Bignum *num2, Bignum *result );
+ *                    Status add_to( Bignum *acc, const Bignum *num );
  *
- * Input Parameters : head1, tail1 -> Pointers to the head and tail of the first number list.
- *                    head2, tail2 -> Pointers to the head and tail of the second number list.
- *                    headR, tailR -> Pointers to the head and tail of the result number list (initially empty).
+ * Input Parameters : num1   -> First number.
+ *                    num2   -> Second number.
+ *                    result -> Number receiving the sum (must not alias num1 or num2).
+ *                    acc    -> add_to(): accumulator updated in place, acc += num.
  *
  * Return Value     : SUCCESS -> If addition is performed successfully.
- *                    FAILURE -> If memory allocation fails during node insertion.
+ *                    FAILURE -> If memory allocation fails while growing the result.
  *
  * Algorithm        :
- *                    1. Initialize carry = 0.
- *                    2. Traverse both lists from the tail (LSD) towards the head (MSD).
- *                    3. Add corresponding digits and the carry (if any).
- *                    4. Insert the resulting digit at the head of the result list.
- *                    5. Continue until all digits and any remaining carry are processed.
- *                    6. Remove any leading zeros from the result list.
+ *                    1. Reserve max(len1, len2) + 1 limbs for the result and initialize carry = 0.
+ *                    2. Walk both limb arrays from index 0 (least significant) upwards (add_limbs() kernel).
+ *                    3. Add corresponding limbs and the carry in double-width arithmetic.
+ *                    4. Store the low half as the result limb and keep the high half as the next carry.
+ *                    5. Continue until all limbs and any remaining carry are processed.
+ *                    6. Remove any leading zero limbs from the result.
  *
  * Notes            :
  *                    • This function assumes both input lists represent non-negative magnitudes.
  *                    • Sign management is handled externally in main().
+ *                    • add_limbs() is the raw limb kernel shared with the multiplication algorithms. On little-endian
+ *                      hosts it adds two limbs as one 64-bit word per add-with-carry (_addcarry_u64 on x86-64, a
+ *                      compare-based carry elsewhere); big-endian hosts take the limb-by-limb loop. It stops walking the
+ *                      longer operand as soon as the carry dies out.
+ *                    • add_to() only touches the limbs the carry reaches, so adding a short term to a long running sum
+ *                      costs the length of the term, with no allocation once the accumulator has grown.
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
 
-Status addition( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR )
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#include <x86intrin.h>
+#endif
+
+/* x + y + carry on 64-bit words, returns the carry out (one ADC on x86-64) */
+static inline unsigned char add_carry_64( unsigned char carry, uint64_t x, uint64_t y, uint64_t *sum )
 {
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+	unsigned long long s;
+	carry = _addcarry_u64( carry, x, y, &s );
+	*sum = s;
+	return carry;
+#else
+	uint64_t t = x + y;
+	*sum = t + carry;
+	return (unsigned char) ( ( t < x ) | ( *sum < t ) );
+#endif
+}
 
-	int carry = 0;
-	Dlist *digits_1 = *tail1;
-	Dlist *digits_2 = *tail2;
+Status addition( const Bignum *num1, const Bignum *num2, Bignum *result )
+{
+	STAT_SCOPE( STAT_ADDITION );
 
-	while( digits_1 || digits_2 || carry )
+	// Let num1 be the longer operand so the kernel only reads num2 while it lasts
+	if( num1 -> len < num2 -> len )
 	{
-		int sum = carry;
+		const Bignum *temp = num1;
+		num1 = num2;
+		num2 = temp;
+	}
+
+	if( reserve_number( result, num1 -> len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	limb_t carry = add_limbs( result -> limbs, num1 -> limbs, num1 -> len, num2 -> limbs, num2 -> len );
+
+	result -> len = num1 -> len;
+	if( carry )
+		result -> limbs[ result -> len++ ] = carry;
+
+	// Remove leading zeroes from result
+	trim_number( result );
 
-		// Add the digits from both numbers if available
-		if( digits_1 )
-		{
-			sum += digits_1 -> data ;
-			digits_1 = digits_1 -> prev;
-		}
+	return SUCCESS;
+}
 
-		if( digits_2 )
-		{
-			sum += digits_2 -> data;
-			digits_2 = digits_2 -> prev;
-		}
+/* Limb kernel: r[0..an) = a + b for an >= bn, returns the carry out. r may alias a or b. */
+limb_t add_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	unsigned char carry = 0;
+	size_t i = 0;
 
-		int digit = sum % 10; // The single digit to be added to the list
-		carry = sum / 10;     // Will be 1 for sum > 9
+#if LIMB_PAIR_WORDS
+	// Four limbs per step as two 64-bit words: on a little-endian host a limb pair loads as its own value
+	for( ; i + 4 <= bn; i += 4 )
+	{
+		uint64_t x[2], y[2], s[2];
+		memcpy( x, a + i, sizeof( x ) );
+		memcpy( y, b + i, sizeof( y ) );
 
-		if( insert_at_first( headR, tailR, digit ) != SUCCESS )
-			return FAILURE;
+		carry = add_carry_64( carry, x[0], y[0], &s[0] );
+		carry = add_carry_64( carry, x[1], y[1], &s[1] );
 
+		memcpy( r + i, s, sizeof( s ) );
 	}
+#endif
 
-	// Remove leading zeroes from result
-	while( (*headR)->next && (*headR)->data == 0 )
-        delete_at_first( headR, tailR );
+	// Add the limbs from both numbers while both are available
+	for( ; i < bn; i++ )
+	{
+		dlimb_t sum = (dlimb_t) a[i] + b[i] + carry;
+		r[i] = (limb_t) sum;
+		carry = (unsigned char) ( sum >> LIMB_BITS );
+	}
+
+	// Propagate the carry through the rest of the longer number; once it stops, the rest is a plain copy
+	for( ; i < an && carry; i++ )
+	{
+		r[i] = a[i] + 1;
+		carry = ( r[i] == 0 );
+	}
+
+	if( r != a && i < an )
+		memcpy( r + i, a + i, ( an - i ) * sizeof( limb_t ) );
+
+	return carry;
+}
+
+/* In place: acc = acc + num, without a separate result number. num may be acc itself. */
+Status add_to( Bignum *acc, const Bignum *num )
+{
+	STAT_SCOPE( STAT_ADD_TO );
+
+	size_t len = acc -> len > num -> len ? acc -> len : num -> len;
+
+	if( reserve_number( acc, len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	// A shorter accumulator is zero extended, so the kernel always walks the accumulator as the longer operand
+	if( acc -> len < len )
+	{
+		memset( acc -> limbs + acc -> len, 0, ( len - acc -> len ) * sizeof( limb_t ) );
+		acc -> len = len;
+	}
+
+	limb_t carry = add_limbs( acc -> limbs, acc -> limbs, acc -> len, num -> limbs, num -> len );
+	if( carry )
+		acc -> limbs[ acc -> len++ ] = carry;
 
 	return SUCCESS;
 }
\ No newline at end of file
@@ -4,9 +4,9 @@
  * Date         : 31/10/2025
  *
  * Description  : Header file defining all structures, enumerations, and function prototypes used in the APC project.
- *                This serves as the shared interface for all source modules implementing arbitrary-precision arithmetic
- *                using doubly linked lists. Each function operates on digit-level linked representations to support
- *                calculations on numbers of unlimited size.
+ *                This serves as the shared interface for all source modules implementing arbitrary-precision arithmetic.
+ *                Every number is stored as a contiguous array of binary limbs (base 2^32) together with its length and
+ *                allocated capacity, so an operand costs 4 bytes per ~9.6 decimal digits and one allocation per number.
  *
  * Purpose      :
  *                • Centralizes all global declarations and data type definitions.
@@ -15,7 +15,7 @@
  *
  * Notes        :
  *                • The project identity and author details are documented in main.c.
- *                • Sign logic and user interaction are managed externally in main().
+ *                • Sign logic and user interaction are managed externally in main(); a Bignum is always a magnitude.
  *******************************************************************************************************************************************************************/
 
 #ifndef APC_H
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 /*-------------------------------------------------------------------------------------------------
  * ENUMERATIONS AND TYPE DEFINITIONS
@@ -38,18 +39,82 @@ typedef enum
     LARGE_2,
     EQUAL,
     EVEN,
-    ODD
+    ODD,
+    ZERO_DIVISOR
 } Status;
 
-typedef int data_t;
+typedef uint32_t limb_t;        /* One base 2^32 digit */
+typedef uint64_t dlimb_t;       /* Double-width limb for products and carries */
 
-/* Doubly Linked List Node Structure */
-typedef struct node
+#define LIMB_BITS       32
+#define DEC_CHUNK       1000000000u     /* Largest power of ten that fits in one limb */
+#define DEC_CHUNK_DIGITS 9
+
+/* Thresholds measured on this machine by "make tune" come first; the defaults below fill in the rest */
+#if defined( __has_include )
+#if __has_include( "apc_tune.h" )
+#include "apc_tune.h"
+#endif
+#endif
+
+/* Multiplication crossover thresholds in limbs (override with -D at build time) */
+#ifndef KARATSUBA_THRESHOLD
+#define KARATSUBA_THRESHOLD 32
+#endif
+
+#ifndef TOOM3_THRESHOLD
+#define TOOM3_THRESHOLD 160
+#endif
+
+#ifndef NTT_THRESHOLD
+#define NTT_THRESHOLD 4000
+#endif
+
+/* Division switches from Algorithm D to Newton reciprocal once divisor and quotient both reach this many limbs */
+#ifndef DIV_NEWTON_THRESHOLD
+#define DIV_NEWTON_THRESHOLD 2500
+#endif
+
+/* Modular power uses Montgomery products for odd moduli below this many limbs, Barrett reduction otherwise */
+#ifndef MONTGOMERY_THRESHOLD
+#define MONTGOMERY_THRESHOLD 160
+#endif
+
+/* Decimal conversion switches from the quadratic loops to divide and conquer above this many limbs */
+#ifndef CONVERT_THRESHOLD
+#define CONVERT_THRESHOLD 40
+#endif
+
+/* Multiplications whose smaller operand has at least this many limbs are split across threads */
+#ifndef PARALLEL_THRESHOLD
+#define PARALLEL_THRESHOLD 1000
+#endif
+
+/* The result cache skips products and divisions whose smaller operand is below this many limbs */
+#ifndef CACHE_MIN_LIMBS
+#define CACHE_MIN_LIMBS 32
+#endif
+
+/* Two adjacent limbs read as one uint64_t hold their value (low limb first) only on little-endian hosts */
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define LIMB_PAIR_WORDS 1
+#else
+#define LIMB_PAIR_WORDS 0
+#endif
+
+#define NTT_MAX_LENGTH  ( (size_t) 1 << 24 )   /* Largest an + bn the three NTT primes support */
+#define RAW_WRITE_CHUNK ( (size_t) 1 << 24 )   /* Bytes per write() call in raw output mode */
+
+/* Packed Number Structure */
+typedef struct
 {
-    struct node *next;
-    struct node *prev;
-    data_t data;
-} Dlist;
+    limb_t *limbs;      /* Least significant limb first */
+    size_t len;         /* Limbs in use, the value zero has len = 0 */
+    size_t cap;         /* Limbs allocated */
+} Bignum;
+
+/* Product callback for window_power(): plain or modular multiplication */
+typedef Status (*Multiply_fn)( const Bignum *num1, const Bignum *num2, Bignum *result, void *ctx );
 
 /*-------------------------------------------------------------------------------------------------
  * FUNCTION PROTOTYPES
@@ -59,29 +124,316 @@ typedef struct node
 int Validate_arguments( int argc , char *argv[] );
 int isNumeric( const char *str );
 
-/* List Operations */
-Status insert_at_first( Dlist **head, Dlist **tail, int digit );
-Status insert_at_last( Dlist **head, Dlist **tail, int digit );
-Status delete_at_first( Dlist **headR, Dlist **tailR );
-void free_list( Dlist **head, Dlist **tail );
-void copy_list( Dlist *srcH, Dlist *srcT, Dlist **dstH, Dlist **dstT );
-void Swap_lists( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2 );
+/* Operand Input ("@path" operands are memory-mapped files) and vectorized digit kernels */
+Status load_operand( const char *token, Bignum *num, char *sign );
+int check_digits( const char *p, size_t n );
+void parse_chunks( const char *p, size_t count, limb_t *chunks );
+
+/* Memory Arena (blocks from an open arena are released together by apc_arena_end) */
+void apc_arena_begin( void );
+void apc_arena_end( void );
+void *apc_alloc( size_t size );
+void *apc_realloc( void *ptr, size_t size );
+void apc_free( void *ptr );
+
+/* Number Storage */
+void init_number( Bignum *num );
+Status reserve_number( Bignum *num, size_t cap );
+void trim_number( Bignum *num );
+void free_number( Bignum *num );
+Status copy_number( const Bignum *src, Bignum *dst );
+Status set_number_word( Bignum *num, limb_t value );
+void Swap_numbers( Bignum *num1, Bignum *num2 );
+Status shift_number_up( Bignum *num, size_t k );
+void shift_number_down( Bignum *num, size_t k );
+Status set_base_power( Bignum *num, size_t k );
+
+/* Limb Kernels (raw little-endian limb arrays) */
+limb_t add_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+limb_t sub_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+Status compare_limbs( const limb_t *a, const limb_t *b, size_t n );
+limb_t lshift_limbs( limb_t *r, const limb_t *a, size_t n, unsigned shift );
+limb_t rshift_limbs( limb_t *r, const limb_t *a, size_t n, unsigned shift );
+
+/* Multiplication Kernels */
+extern size_t karatsuba_threshold;
+extern size_t toom3_threshold;
+extern size_t ntt_threshold;
+
+/* One independent limb product for mul_jobs() */
+typedef struct
+{
+    limb_t *r;
+    const limb_t *a, *b;
+    size_t an, bn;
+    Status status;
+} Mul_job;
+
+Status mul_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+void mul_basecase( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+limb_t mul_word( limb_t *r, const limb_t *a, size_t n, limb_t w );
+limb_t addmul_word( limb_t *r, const limb_t *a, size_t n, limb_t w );
+Status mul_karatsuba( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+Status mul_toom3( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+Status mul_ntt( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+Status mul_jobs( Mul_job *jobs, size_t count );
+
+/* Parallel Multiplication (mul_threads = 0 uses every online core) */
+typedef void (*Range_fn)( void *ctx, size_t lo, size_t hi );
+
+extern size_t mul_threads;
+extern size_t parallel_threshold;
+
+size_t parallel_threads( void );
+void parallel_for( size_t n, Range_fn body, void *ctx );
+
+/* Division Kernels */
+extern size_t div_newton_threshold;
+
+/* Normalized divisor with its Newton reciprocal, reusable across divisions */
+typedef struct
+{
+    Bignum b;           /* Divisor shifted left by shift bits */
+    Bignum X;           /* floor( B^(2n) / b ), n = b.len */
+    unsigned shift;
+} Reciprocal;
+
+/* One-limb divisor with its precomputed inverse, reusable across divisions */
+typedef struct
+{
+    dlimb_t d;          /* Divisor shifted to the top bit of a 64-bit word */
+    dlimb_t v;          /* floor( (2^128 - 1) / d ) - 2^64 */
+    unsigned shift;     /* Left shift that normalized the divisor limb */
+} Word_divisor;
+
+/* Operands of the last division with both of its results, so "a / b" and "a % b" share one division */
+typedef struct
+{
+    Bignum num1, num2;  /* Dividend and divisor magnitudes */
+    Bignum quot, rem;
+    int valid;          /* Zero until the first division, a zero-filled memo is empty */
+} Divmod_memo;
+
+Status divide_numbers( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem );
+limb_t div_word( limb_t *q, const limb_t *a, size_t n, limb_t d );
+void word_divisor_init( Word_divisor *W, limb_t d );
+limb_t div_word_preinv( limb_t *q, const limb_t *a, size_t n, const Word_divisor *W );
+Status div_knuth( limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+Status div_newton( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem );
+Status reciprocal_init( Reciprocal *R, const Bignum *divisor );
+Status reciprocal_divide( const Bignum *num, const Reciprocal *R, Bignum *quot, Bignum *rem );
+void reciprocal_free( Reciprocal *R );
+
+/* Radix Conversion */
+extern size_t convert_threshold;
+
+Status decimal_to_number( Bignum *num, const char *digits, size_t count );
+Status number_to_decimal( const Bignum *num, char *out, size_t width );
 
 /* Utility Functions */
-void String_to_list( Dlist **head, Dlist **tail, const char *str );
-void subtract_one( Dlist **head, Dlist **tail );
-Status Find_largest( Dlist *head1, Dlist *head2 );
-Status is_exp_even( Dlist *expH );
-Status increment_list( Dlist **head, Dlist **tail );
+Status String_to_number( Bignum *num, const char *str );
+char *Number_to_string( const Bignum *num );
+void subtract_one( Bignum *num );
+Status Find_largest( const Bignum *num1, const Bignum *num2 );
+Status is_exp_even( const Bignum *exp );
+Status increment_number( Bignum *num );
 
 /* Arithmetic Operations */
-Status addition( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR );
-Status subtraction( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR );
-Status multiplication( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR );
-Status division( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR , char* D_or_M );
-Status power( Dlist **baseH, Dlist **baseT, Dlist **expH, Dlist **expT, Dlist **headR, Dlist **tailR );
+Status addition( const Bignum *num1, const Bignum *num2, Bignum *result );
+Status subtraction( const Bignum *num1, const Bignum *num2, Bignum *result );
+Status add_to( Bignum *acc, const Bignum *num );
+Status sub_from( Bignum *acc, const Bignum *num );
+Status multiplication( const Bignum *num1, const Bignum *num2, Bignum *result );
+Status mul_small( Bignum *num, limb_t w );
+Status mul_add( Bignum *acc, const Bignum *b, const Bignum *c );
+Status division( const Bignum *num1, const Bignum *num2, Bignum *result, char* D_or_M );
+Status divmod( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem );
+Status divmod_cached( Divmod_memo *memo, const Bignum *num1, const Bignum *num2, Bignum *result, int quotient );
+void divmod_memo_free( Divmod_memo *memo );
+Status divmod_small( Bignum *num, limb_t d, limb_t *rem );
+Status power( const Bignum *base, const Bignum *exp, Bignum *result );
+Status window_power( const Bignum *base, const Bignum *exp, Bignum *result, Multiply_fn multiply, void *ctx );
+
+/* Modular Exponentiation */
+extern size_t montgomery_threshold;
+
+Status mod_power( const Bignum *base, const Bignum *exp, const Bignum *mod, Bignum *result );
+
+/* Result Cache (content-addressed LRU shared by every thread, off until cache_enable()) */
+Status cache_enable( size_t budget );
+Status cache_apply( char operator, const Bignum *num1, const Bignum *num2, const Bignum *num3, Bignum *result,
+                    Divmod_memo *memo );
+char *cache_decimal( const Bignum *num );
+Status cache_report( FILE *out );
+
+/* Work-Stealing Thread Pool */
+typedef struct Pool Pool;
+typedef void (*Task_fn)( void *arg );
+
+Pool *pool_create( int threads );
+Status pool_submit( Pool *pool, Task_fn fn, void *arg );
+void pool_destroy( Pool *pool );
+
+/* Instrumentation (built with -DAPC_STATS, the hooks compile to nothing otherwise) */
+#ifdef APC_STATS
+typedef enum
+{
+    STAT_ADDITION,
+    STAT_SUBTRACTION,
+    STAT_ADD_TO,
+    STAT_SUB_FROM,
+    STAT_MULTIPLICATION,
+    STAT_MUL_BASECASE,
+    STAT_KARATSUBA,
+    STAT_TOOM3,
+    STAT_NTT,
+    STAT_MUL_ADD,
+    STAT_MUL_SMALL,
+    STAT_DIVISION,
+    STAT_DIVMOD,
+    STAT_DIV_WORD,
+    STAT_DIV_WORD_PREINV,
+    STAT_DIV_KNUTH,
+    STAT_DIV_NEWTON,
+    STAT_RECIPROCAL_INIT,
+    STAT_RECIPROCAL_DIVIDE,
+    STAT_POWER,
+    STAT_MOD_POWER,
+    STAT_PARSE,
+    STAT_PRINT,
+    STAT_LOAD_OPERAND,
+    STAT_COUNT
+} Stat_id;
+
+/* One timed call, recorded by stats_leave() when the enclosing function returns */
+typedef struct
+{
+    Stat_id id;
+    uint64_t start;
+} Stat_scope;
+
+Stat_scope stats_enter( Stat_id id );
+void stats_leave( Stat_scope *scope );
+void stats_alloc( size_t bytes, int system );
+void stats_free( size_t bytes, size_t blocks );
+void stats_realloc( size_t old_bytes, size_t new_bytes );
+
+#define STAT_SCOPE( id )                Stat_scope stat_scope_ __attribute__(( cleanup( stats_leave ) )) = stats_enter( id )
+#define STAT_ALLOC( bytes, system )     stats_alloc( bytes, system )
+#define STAT_FREE( bytes, blocks )      stats_free( bytes, blocks )
+#define STAT_REALLOC( old, new )        stats_realloc( old, new )
+#else
+#define STAT_SCOPE( id )
+#define STAT_ALLOC( bytes, system )
+#define STAT_FREE( bytes, blocks )
+#define STAT_REALLOC( old, new )
+#endif
+
+Status stats_dump( FILE *out );
+
+/* Expression Engine */
+typedef enum
+{
+    EXPR_NUMBER,
+    EXPR_VARIABLE,
+    EXPR_NEGATE,
+    EXPR_BINARY,
+    EXPR_ASSIGN
+} Expr_kind;
+
+/* Node of a parsed statement */
+typedef struct Expr_node
+{
+    Expr_kind kind;
+    char op;                        /* Binary operator: + - x / % ^ */
+    char sign;                      /* Sign of a number */
+    Bignum value;                   /* Magnitude of a number, converted while parsing */
+    char *name;                     /* Variable read or assigned */
+    struct Expr_node *left, *right; /* Operands; a negation or an assignment only uses left */
+} Expr_node;
+
+typedef struct
+{
+    char *name;
+    Bignum value;
+    char sign;
+} Expr_variable;
+
+/* Variables defined by the statements run so far */
+typedef struct
+{
+    Expr_variable *vars;
+    size_t count, cap;
+} Expr_env;
+
+Expr_node *expr_parse( const char **text, const Expr_env *env, char *error, size_t error_size );
+Status expr_evaluate( const Expr_node *node, Expr_env *env, Bignum *scratch, const Bignum **value, char *sign );
+void expr_free( Expr_node *node );
+void env_free( Expr_env *env );
+
+/* Compiled Expression Plans */
+typedef enum
+{
+    PLAN_ADD,
+    PLAN_SUB,
+    PLAN_MUL,
+    PLAN_DIV,
+    PLAN_MOD,
+    PLAN_POW,
+    PLAN_MODPOW,        /* a ^ b % c */
+    PLAN_DIVMOD         /* dst = a / b and dst2 = a % b */
+} Plan_op;
+
+/* Step operand: a register, read with its sign flipped when negate is set */
+typedef struct
+{
+    size_t reg;
+    int negate;
+} Plan_ref;
+
+typedef struct
+{
+    Plan_op op;
+    size_t dst, dst2;
+    Plan_ref a, b, c;
+} Plan_step;
+
+typedef struct
+{
+    Bignum num;
+    char sign;
+} Plan_register;
+
+/* Flat program over a register file: inputs first, then constants, then reused temporaries */
+typedef struct
+{
+    Plan_step *steps;
+    size_t step_count;
+    Plan_register *regs;
+    size_t reg_count;
+    char **inputs;              /* Input names, in order of first appearance */
+    size_t input_count;
+    Plan_ref result;
+} Plan;
+
+Status plan_compile( const Expr_node *root, Plan *plan );
+Status plan_run( Plan *plan, const Bignum **value, char *sign );
+void plan_free( Plan *plan );
+
+/* Evaluation Front Ends */
+Status calculate( int argc, char *argv[], Bignum *num1, Bignum *num2, Bignum *num3, Bignum *result, char *final_sign,
+                  Divmod_memo *memo );
+Status apply_operator( char operator, const Bignum *num1, char sign1, const Bignum *num2, char sign2, const Bignum *num3,
+                       char sign3, Bignum *result, char *final_sign, Divmod_memo *memo );
+Status run_batch( FILE *in, FILE *out );
+Status run_batch_parallel( FILE *in, FILE *out, int threads );
+Status run_batch_fd( int in_fd, int out_fd, int allow_files, size_t max_line );
+Status run_server( const char *path, int threads );
+Status run_expressions( const char *program, FILE *in, FILE *out );
+Status run_plan( const char *expression, FILE *in, FILE *out );
 
 /* Output Function */
-void print_calculation( char *num1, char op, char *num2, Dlist *headR, char* final_sign );
+void print_calculation( char *num1, char op, char *num2, char *num3, const Bignum *result, char* final_sign );
+Status print_raw( int fd, const Bignum *result, char final_sign );
 
 #endif /* APC_H */
@@ -0,0 +1,233 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : apc_alloc / apc_realloc / apc_free / apc_arena_begin / apc_arena_end
+ * Description      : Per-evaluation memory arena for limb arrays and kernel scratch buffers. While an arena is open on the
+ *                    calling thread, small and mid-size blocks are carved out of large chunks and recycled through size-class
+ *                    free lists (powers of two from 64 bytes), so the constant allocate / grow / release traffic of the
+ *                    multiplication and division kernels never reaches malloc. Closing the arena releases every chunk at once.
+ *
+ * Prototype        : void *apc_alloc( size_t size );
+ *                    void *apc_realloc( void *ptr, size_t size );
+ *                    void apc_free( void *ptr );
+ *                    void apc_arena_begin( void );
+ *                    void apc_arena_end( void );
+ *
+ * Input Parameters : size   -> Bytes requested.
+ *                    ptr    -> Block previously returned by apc_alloc() / apc_realloc() (NULL is allowed).
+ *
+ * Return Value     : apc_alloc / apc_realloc -> Pointer to the block, NULL if memory is exhausted (the old block of
+ *                                               apc_realloc() is then left untouched, as with realloc()).
+ *
+ * Special Cases    :
+ *                    • No arena open → blocks come straight from malloc(), so the functions are safe to use anywhere.
+ *                    • Blocks above ARENA_MAX_BLOCK bytes always use malloc(); they are few, and malloc() maps them directly.
+ *                    • Nested apc_arena_begin() calls are counted; only the outermost apc_arena_end() releases memory.
+ *
+ * Algorithm        :
+ *                    1. Every block carries a 16-byte header: owning arena (NULL for malloc blocks) and usable size.
+ *                    2. apc_alloc(): round the size up to its class, pop the class free list if it is not empty,
+ *                       otherwise bump-allocate from the current chunk (opening a new ARENA_CHUNK chunk when full).
+ *                    3. apc_free(): push arena blocks on their class free list, free() malloc blocks.
+ *                    4. apc_realloc(): keep the block when its class already fits, otherwise move to a larger class.
+ *                    5. apc_arena_end(): free all chunks and reset the free lists.
+ *
+ * Notes            :
+ *                    • Arenas are thread-local; a block must be released by the thread that owns its arena.
+ *                    • Numbers allocated inside an evaluation must not be used or freed after apc_arena_end().
+ *                    • Power-of-two classes waste at most half a block, and reserve_number() already grows geometrically.
+ *                    • With APC_STATS every call reports to stats.c; each arena tracks its live bytes so that the bulk
+ *                      release in apc_arena_end() lowers the live total as well.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+#define ARENA_MIN_SHIFT 6								/* Smallest class: 64 bytes */
+#define ARENA_CLASSES   13								/* Classes 64 bytes .. 256 KiB */
+#define ARENA_MAX_BLOCK ( (size_t) 1 << ( ARENA_MIN_SHIFT + ARENA_CLASSES - 1 ) )
+#define ARENA_CHUNK     ( (size_t) 1 << 20 )			/* Bytes requested from malloc() at a time */
+
+typedef struct Arena Arena;
+
+typedef struct
+{
+	Arena *owner;		// Arena the block came from, NULL for malloc() blocks
+	size_t size;		// Usable bytes after the header
+} Block_header;
+
+typedef struct Chunk
+{
+	struct Chunk *next;
+	size_t pad;			// Keeps the data 16-byte aligned
+} Chunk;
+
+struct Arena
+{
+	int depth;							// Open apc_arena_begin() calls
+	Chunk *chunks;						// Every chunk, newest first
+	char *next, *end;					// Bump region of the newest chunk
+	void *free_list[ ARENA_CLASSES ];	// Released blocks per class
+#ifdef APC_STATS
+	size_t live;						// Bytes of handed-out blocks, dropped in bulk by apc_arena_end()
+#endif
+};
+
+static _Thread_local Arena arena;
+
+/* Smallest class whose block holds size bytes */
+static int size_class( size_t size )
+{
+	int c = 0;
+	while( ( (size_t) 1 << ( ARENA_MIN_SHIFT + c ) ) < size )
+		c++;
+
+	return c;
+}
+
+void apc_arena_begin( void )
+{
+	arena.depth++;
+}
+
+void apc_arena_end( void )
+{
+	if( arena.depth == 0 || --arena.depth > 0 )
+		return;
+
+	// Bulk release of everything allocated since the outermost begin
+	while( arena.chunks )
+	{
+		Chunk *next = arena.chunks -> next;
+		free( arena.chunks );
+		arena.chunks = next;
+	}
+
+	arena.next = arena.end = NULL;
+	memset( arena.free_list, 0, sizeof( arena.free_list ) );
+
+#ifdef APC_STATS
+	STAT_FREE( arena.live, 0 );
+	arena.live = 0;
+#endif
+}
+
+void *apc_alloc( size_t size )
+{
+	Block_header *h;
+
+	// Outside an arena, or too large to pool: plain malloc()
+	if( arena.depth == 0 || size > ARENA_MAX_BLOCK )
+	{
+		h = malloc( sizeof( Block_header ) + size );
+		if( h == NULL )
+			return NULL;
+
+		h -> owner = NULL;
+		h -> size = size;
+		STAT_ALLOC( size, 1 );
+		return h + 1;
+	}
+
+	int c = size_class( size );
+	size_t block = (size_t) 1 << ( ARENA_MIN_SHIFT + c );
+
+	// Reuse a released block of the same class
+	if( arena.free_list[c] )
+	{
+		void *p = arena.free_list[c];
+		arena.free_list[c] = *(void **) p;
+#ifdef APC_STATS
+		arena.live += block;
+		STAT_ALLOC( block, 0 );
+#endif
+		return p;
+	}
+
+	// Bump allocation, opening a new chunk when the current one is full
+	size_t need = sizeof( Block_header ) + block;
+	int system = 0;
+	if( (size_t) ( arena.end - arena.next ) < need )
+	{
+		Chunk *chunk = malloc( sizeof( Chunk ) + ARENA_CHUNK );
+		if( chunk == NULL )
+			return NULL;
+
+		chunk -> next = arena.chunks;
+		arena.chunks = chunk;
+		arena.next = (char *) ( chunk + 1 );
+		arena.end = arena.next + ARENA_CHUNK;
+		system = 1;
+	}
+
+	h = (Block_header *) arena.next;
+	arena.next += need;
+
+	h -> owner = &arena;
+	h -> size = block;
+#ifdef APC_STATS
+	arena.live += block;
+#endif
+	STAT_ALLOC( block, system );
+	(void) system;
+	return h + 1;
+}
+
+void apc_free( void *ptr )
+{
+	if( ptr == NULL )
+		return;
+
+	Block_header *h = (Block_header *) ptr - 1;
+
+	STAT_FREE( h -> size, 1 );
+
+	if( h -> owner == NULL )
+	{
+		free( h );
+		return;
+	}
+
+#ifdef APC_STATS
+	h -> owner -> live -= h -> size;
+#endif
+
+	// Back on its class list, the chunk itself is released by apc_arena_end()
+	int c = size_class( h -> size );
+	*(void **) ptr = h -> owner -> free_list[c];
+	h -> owner -> free_list[c] = ptr;
+}
+
+void *apc_realloc( void *ptr, size_t size )
+{
+	if( ptr == NULL )
+		return apc_alloc( size );
+
+	Block_header *h = (Block_header *) ptr - 1;
+
+	// The block's class already has room
+	if( size <= h -> size )
+	{
+		STAT_REALLOC( h -> size, h -> size );
+		return ptr;
+	}
+
+	// Large malloc() block stays a malloc() block, realloc() can move it without copying
+	if( h -> owner == NULL && size > ARENA_MAX_BLOCK )
+	{
+		Block_header *n = realloc( h, sizeof( Block_header ) + size );
+		if( n == NULL )
+			return NULL;
+
+		STAT_REALLOC( n -> size, size );
+		n -> size = size;
+		return n + 1;
+	}
+
+	void *p = apc_alloc( size );
+	if( p == NULL )
+		return NULL;
+
+	STAT_REALLOC( 0, 0 );
+	memcpy( p, ptr, h -> size );
+	apc_free( ptr );
+
+	return p;
+}
\ No newline at end of file
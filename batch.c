@@ -0,0 +1,490 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : run_batch / run_batch_parallel
+ * Description      : Streams newline-delimited calculations from a file (or stdin) and writes one result per line. Each line uses
+ *                    the command-line layout "<number1> <operator> <number2>" or "<base> ^ <exponent> % <modulus>", with tokens
+ *                    separated by blanks. The operand, result and scratch buffers stay alive across lines and are recycled
+ *                    through the arena, so a small calculation costs a parse and a few limb operations instead of a process.
+ *                    run_batch_parallel() spreads the lines over a work-stealing thread pool (pool.c) and still writes the
+ *                    results in input order.
+ *
+ * Prototype        : Status run_batch( FILE *in, FILE *out );
+ *                    Status run_batch_parallel( FILE *in, FILE *out, int threads );
+ *                    Status run_batch_fd( int in_fd, int out_fd, int allow_files, size_t max_line );
+ *
+ * Input Parameters : in      -> Stream of calculations, one per line.
+ *                    out     -> Stream receiving one result line per input line.
+ *                    threads -> Worker threads; 1 runs run_batch() on the calling thread.
+ *                    in_fd, out_fd -> Descriptors of a request / response stream, e.g. both ends of one socket connection.
+ *                    allow_files   -> Zero answers "@path" operands with "ERROR: Invalid Input" instead of opening the
+ *                                     file, for input from untrusted peers (server mode).
+ *                    max_line      -> Longest line accepted in bytes, 0 for no limit. A longer line is answered with
+ *                                     "ERROR: Line Too Long" and ends the stream.
+ *
+ * Return Value     : SUCCESS -> All input was read and every result line was written.
+ *                    FAILURE -> Reading the input or writing the output failed (for run_batch_fd, also a peer that
+ *                               went away before reading its answers, a read or write that timed out, or a line
+ *                               longer than max_line).
+ *
+ * Output Format    :
+ *                    • Result      → Plain signed decimal, e.g. "-69104" (zero is always "0").
+ *                    • Blank line  → Blank line, so output line i always answers input line i.
+ *                    • Bad line    → "ERROR: Invalid Input" (also an "@path" operand whose file holds no number)
+ *                    • Divisor 0   → "ERROR: Division by Zero"
+ *                    • Other error → "ERROR: Calculation Failure"
+ *                    • Too long    → "ERROR: Line Too Long" (run_batch_fd with a max_line only; nothing follows it)
+ *
+ * Algorithm (run_batch_parallel):
+ *                    1. The reader groups lines into tasks of up to TASK_LINES lines or TASK_BYTES bytes.
+ *                    2. Each task is submitted to the pool; a worker evaluates it into its own memory stream, using its own
+ *                       numbers and its own thread-local arena, so tasks share no mutable state.
+ *                    3. Tasks sit in a reorder buffer of TASKS_PER_THREAD × threads slots indexed by sequence number. The
+ *                       reader writes finished tasks strictly in sequence order, and waits for the oldest one whenever the
+ *                       buffer is full, which also bounds memory on endless input.
+ *
+ * Notes            :
+ *                    • A failing line only affects its own output line; evaluation continues with the next one. The same
+ *                      holds for a run_batch_parallel() task whose output buffer cannot be allocated: its lines read
+ *                      "ERROR: Calculation Failure", later lines are still answered, and only the return value says FAILURE.
+ *                    • Lines can be arbitrarily long, unlike command-line operands which are capped by ARG_MAX.
+ *                    • run_batch_fd() is for interactive peers (server mode): instead of filling a stdio buffer it answers
+ *                      all complete lines of each read() with one write(), so a client waiting for its answer never waits
+ *                      on a buffer, and a client that pipelines many lines still gets them answered in large writes.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/* Largest token count of a valid line, plus the argv[0] slot */
+#define MAX_TOKENS 6
+
+/* Parallel mode: lines per task, input bytes per task, and tasks in flight per worker (reorder window) */
+#define TASK_LINES       256
+#define TASK_BYTES       ( 1 << 16 )
+#define TASKS_PER_THREAD 8
+
+/* Bytes requested per read() in descriptor mode */
+#define FD_READ_CHUNK    ( 1 << 16 )
+
+/* Operand, modulus and result numbers, reused from line to line, and the last division's quotient and remainder */
+typedef struct
+{
+	Bignum num1, num2, num3, result;
+	Divmod_memo memo;
+} Batch_numbers;
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	pthread_cond_t done_cv;		// Signalled whenever a task finishes
+} Batch_shared;
+
+typedef struct
+{
+	Batch_shared *shared;
+	char *input;				// Lines of the task, each ending in '\n'
+	size_t len, cap, lines;
+	char *output;				// Result lines, NULL if they could not be produced
+	size_t out_len;
+	int done;
+} Batch_task;
+
+/* Split a line in place into argv-style tokens, returns the token count (argc) or MAX_TOKENS + 1 if there are too many */
+static int split_line( char *line, char *tokens[] )
+{
+	int count = 1;
+	tokens[0] = "batch";
+
+	char *p = line;
+	while( 1 )
+	{
+		while( isspace( (unsigned char) *p ) )
+			p++;
+		if( *p == '\0' )
+			break;
+
+		if( count == MAX_TOKENS )
+			return MAX_TOKENS + 1;
+
+		tokens[ count++ ] = p;
+		while( *p && !isspace( (unsigned char) *p ) )
+			p++;
+		if( *p )
+			*p++ = '\0';
+	}
+
+	return count;
+}
+
+/* True if any operand names a file ("@path") */
+static int has_file_operand( int count, char *tokens[] )
+{
+	for( int i = 1; i < count; i++ )
+		if( tokens[i][0] == '@' )
+			return 1;
+
+	return 0;
+}
+
+/* Evaluate one line and write its result line; allow_files = 0 answers "@path" operands as invalid input */
+static void evaluate_line( char *line, FILE *out, Batch_numbers *nums, int allow_files )
+{
+	char *tokens[ MAX_TOKENS ];
+	int count = split_line( line, tokens );
+
+	if( count == 1 )
+	{
+		fputc( '\n', out );
+		return;
+	}
+
+	if( count > MAX_TOKENS || ( !allow_files && has_file_operand( count, tokens ) )
+		|| Validate_arguments( count, tokens ) == FAILURE )
+	{
+		fputs( "ERROR: Invalid Input\n", out );
+		return;
+	}
+
+	char final_sign;
+	Status calc = calculate( count, tokens, &nums -> num1, &nums -> num2, &nums -> num3, &nums -> result, &final_sign,
+							 &nums -> memo );
+
+	if( calc == ZERO_DIVISOR )
+	{
+		fputs( "ERROR: Division by Zero\n", out );
+		return;
+	}
+
+	if( calc == NON_NUMERIC )
+	{
+		fputs( "ERROR: Invalid Input\n", out );
+		return;
+	}
+
+	char *digits = ( calc == SUCCESS ) ? cache_decimal( &nums -> result ) : NULL;
+	if( digits == NULL )
+	{
+		fputs( "ERROR: Calculation Failure\n", out );
+		return;
+	}
+
+	if( final_sign == '-' && nums -> result.len )
+		fputc( '-', out );
+	fputs( digits, out );
+	fputc( '\n', out );
+
+	free( digits );
+}
+
+static void free_batch_numbers( Batch_numbers *nums )
+{
+	free_number( &nums -> num1 );
+	free_number( &nums -> num2 );
+	free_number( &nums -> num3 );
+	free_number( &nums -> result );
+	divmod_memo_free( &nums -> memo );
+}
+
+Status run_batch( FILE *in, FILE *out )
+{
+	apc_arena_begin();
+
+	Batch_numbers nums = { 0 };
+
+	char *line = NULL;
+	size_t line_cap = 0;
+	Status status = SUCCESS;
+
+	while( getline( &line, &line_cap, in ) != -1 )
+		evaluate_line( line, out, &nums, 1 );
+
+	if( ferror( in ) || fflush( out ) == EOF )
+		status = FAILURE;
+
+	free( line );
+	free_batch_numbers( &nums );
+	apc_arena_end();
+
+	return status;
+}
+
+/* Writes all of buf to fd, across short writes and interrupted calls */
+static Status write_all( int fd, const char *buf, size_t len )
+{
+	while( len )
+	{
+		ssize_t n = write( fd, buf, len );
+		if( n < 0 && errno == EINTR )
+			continue;
+		if( n <= 0 )
+			return FAILURE;
+
+		buf += n;
+		len -= (size_t) n;
+	}
+
+	return SUCCESS;
+}
+
+Status run_batch_fd( int in_fd, int out_fd, int allow_files, size_t max_line )
+{
+	apc_arena_begin();
+
+	Batch_numbers nums = { 0 };
+	Status status = SUCCESS;
+
+	char *buf = NULL;
+	size_t len = 0, cap = 0;
+	int eof = 0;
+
+	while( status == SUCCESS && !eof )
+	{
+		// Room for the next read after a partial line, which may be arbitrarily long
+		if( cap - len < FD_READ_CHUNK )
+		{
+			size_t new_cap = cap ? 2 * cap : 2 * FD_READ_CHUNK;
+			char *grown = realloc( buf, new_cap + 1 );
+			if( grown == NULL )
+			{
+				perror("INFO : Memory Allocation Failed");
+				status = FAILURE;
+				break;
+			}
+			buf = grown;
+			cap = new_cap;
+		}
+
+		ssize_t n = read( in_fd, buf + len, cap - len );
+		if( n < 0 && errno == EINTR )
+			continue;
+		if( n < 0 )
+		{
+			status = FAILURE;
+			break;
+		}
+
+		len += (size_t) n;
+		eof = ( n == 0 );
+
+		// A last line without its newline still counts at end of input
+		if( eof && len && buf[ len - 1 ] != '\n' )
+			buf[ len++ ] = '\n';
+
+		// Answer every complete line received so far in one write, before blocking on the next read
+		char *output = NULL;
+		size_t out_len = 0;
+		FILE *out = open_memstream( &output, &out_len );
+		if( out == NULL )
+		{
+			status = FAILURE;
+			break;
+		}
+
+		char *p = buf, *nl;
+		while( ( nl = memchr( p, '\n', (size_t) ( buf + len - p ) ) ) != NULL )
+		{
+			*nl = '\0';
+			evaluate_line( p, out, &nums, allow_files );
+			p = nl + 1;
+		}
+
+		if( fclose( out ) != 0 || write_all( out_fd, output, out_len ) != SUCCESS )
+			status = FAILURE;
+		free( output );
+
+		// Keep the partial line for the next read, unless it already exceeds the limit
+		len -= (size_t) ( p - buf );
+		memmove( buf, p, len );
+
+		if( status == SUCCESS && max_line && len > max_line )
+		{
+			static const char too_long[] = "ERROR: Line Too Long\n";
+			write_all( out_fd, too_long, sizeof( too_long ) - 1 );
+			status = FAILURE;
+		}
+	}
+
+	free( buf );
+	free_batch_numbers( &nums );
+	apc_arena_end();
+
+	return status;
+}
+
+/* Worker side: evaluate every line of a task into its own output buffer */
+static void batch_task_run( void *arg )
+{
+	Batch_task *task = arg;
+
+	FILE *out = open_memstream( &task -> output, &task -> out_len );
+	if( out )
+	{
+		apc_arena_begin();
+		Batch_numbers nums = { 0 };
+
+		char *p = task -> input,
+			 *end = task -> input + task -> len;
+		while( p < end )
+		{
+			char *nl = memchr( p, '\n', (size_t) ( end - p ) );
+			*nl = '\0';
+			evaluate_line( p, out, &nums, 1 );
+			p = nl + 1;
+		}
+
+		free_batch_numbers( &nums );
+		apc_arena_end();
+
+		if( fclose( out ) != 0 )
+		{
+			free( task -> output );
+			task -> output = NULL;
+		}
+	}
+
+	pthread_mutex_lock( &task -> shared -> lock );
+	task -> done = 1;
+	pthread_cond_broadcast( &task -> shared -> done_cv );
+	pthread_mutex_unlock( &task -> shared -> lock );
+}
+
+/* Writer side: output of the oldest task, waiting for it if wait is set; returns 0 if it is not ready.
+   A task whose output stream could not be built sets *failed, which only changes the exit status. */
+static int write_task( Batch_task *task, FILE *out, int wait, int *failed )
+{
+	pthread_mutex_lock( &task -> shared -> lock );
+	while( wait && !task -> done )
+		pthread_cond_wait( &task -> shared -> done_cv, &task -> shared -> lock );
+	int done = task -> done;
+	pthread_mutex_unlock( &task -> shared -> lock );
+
+	if( !done )
+		return 0;
+
+	if( task -> output )
+		fwrite( task -> output, 1, task -> out_len, out );
+	else
+	{
+		// Keep output line i answering input line i
+		for( size_t i = 0; i < task -> lines; i++ )
+			fputs( "ERROR: Calculation Failure\n", out );
+		*failed = 1;
+	}
+
+	free( task -> input );
+	free( task -> output );
+	free( task );
+	return 1;
+}
+
+Status run_batch_parallel( FILE *in, FILE *out, int threads )
+{
+	if( threads <= 1 )
+		return run_batch( in, out );
+
+	Pool *pool = pool_create( threads );
+	size_t window = (size_t) threads * TASKS_PER_THREAD;
+	Batch_task **slots = calloc( window, sizeof( Batch_task * ) );
+
+	if( pool == NULL || slots == NULL )
+	{
+		if( pool )
+			pool_destroy( pool );
+		free( slots );
+		return run_batch( in, out );
+	}
+
+	Batch_shared shared;
+	pthread_mutex_init( &shared.lock, NULL );
+	pthread_cond_init( &shared.done_cv, NULL );
+
+	Status status = SUCCESS;
+	int failed = 0;
+	size_t submitted = 0, written = 0;
+	Batch_task *task = NULL;
+
+	char *line = NULL;
+	size_t line_cap = 0;
+	ssize_t n = 0;
+
+	// Only a failed read or write, or a task that cannot be allocated, stops the reader
+	while( !ferror( out ) )
+	{
+		n = getline( &line, &line_cap, in );
+
+		// Append the line to the task being filled
+		if( n != -1 )
+		{
+			if( task == NULL && ( task = calloc( 1, sizeof( Batch_task ) ) ) == NULL )
+			{
+				perror("INFO : Memory Allocation Failed");
+				status = FAILURE;
+				break;
+			}
+
+			if( task -> len + (size_t) n + 1 > task -> cap )
+			{
+				size_t cap = 2 * ( task -> len + (size_t) n + 1 );
+				char *input = realloc( task -> input, cap );
+				if( input == NULL )
+				{
+					perror("INFO : Memory Allocation Failed");
+					status = FAILURE;
+					break;
+				}
+				task -> input = input;
+				task -> cap = cap;
+			}
+
+			memcpy( task -> input + task -> len, line, (size_t) n );
+			task -> len += (size_t) n;
+			if( line[n - 1] != '\n' )
+				task -> input[ task -> len++ ] = '\n';
+			task -> lines++;
+		}
+
+		// Hand the task to the pool once it is full, or at end of input
+		if( task && ( n == -1 || task -> lines == TASK_LINES || task -> len >= TASK_BYTES ) )
+		{
+			// Reorder window full: the oldest task has to be written first
+			if( submitted - written == window )
+				write_task( slots[ written++ % window ], out, 1, &failed );
+
+			task -> shared = &shared;
+			slots[ submitted++ % window ] = task;
+			if( pool_submit( pool, batch_task_run, task ) != SUCCESS )
+				batch_task_run( task );
+			task = NULL;
+		}
+
+		// Write whatever is already finished, in input order
+		while( written < submitted && write_task( slots[ written % window ], out, 0, &failed ) )
+			written++;
+
+		if( n == -1 )
+			break;
+	}
+
+	// Drain the reorder buffer
+	while( written < submitted )
+		write_task( slots[ written++ % window ], out, 1, &failed );
+
+	if( task )
+	{
+		free( task -> input );
+		free( task );
+	}
+
+	pool_destroy( pool );
+	pthread_mutex_destroy( &shared.lock );
+	pthread_cond_destroy( &shared.done_cv );
+	free( slots );
+	free( line );
+
+	if( failed || ferror( in ) || fflush( out ) == EOF )
+		status = FAILURE;
+
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+/*******************************************************************************************************************************************************************
+ * Title        : APC Benchmark Suite
+ * Project      : APC - Arbitrary Precision Calculator
+ *
+ * Description  : Measures every operation of the calculator over a range of operand sizes and prints one record per
+ *                (operation, size) point as CSV or JSON, so that runs can be diffed to catch regressions and plotted to find
+ *                the crossover points of the size-based algorithms. Built and run by "make bench"; it links the same
+ *                objects as apc.out, so it measures exactly the code that ships.
+ *
+ * Usage        : ./apc_bench [--json] [--min digits] [--max digits] [--time seconds] [--ops list] [-j threads] [-o file]
+ *                  --json     JSON array instead of CSV.
+ *                  --min/max  Operand sizes in decimal digits, 1-3 steps per decade (default 10 to 10000000).
+ *                  --time     Minimum measuring time per point (default 0.2 s); a point slower than this runs once.
+ *                  --ops      Comma separated subset of: add,sub,mul,div,pow,parse,print (default all).
+ *                  -j         Threads for large multiplications (default all online cores, as apc.out).
+ *                  -o         Output file (default stdout); progress always goes to stderr.
+ *                Example → make bench BENCH_ARGS="--max 1000000 --json -o bench.json"
+ *
+ * Operations   : (n = size in digits; operands are random limbs of about n digits)
+ *                  add    → addition( n, n )          sub   → subtraction( n, n/2 )
+ *                  mul    → multiplication( n, n )    div   → division( 2n, n ), quotient of n digits
+ *                  pow    → power( 3, e ), e chosen so the result has n digits
+ *                  parse  → decimal_to_number() of n digits
+ *                  print  → number_to_decimal() of an n-digit number
+ *
+ * Output       : op, digits, limbs, reps, ns_per_op, digits_per_sec, peak_rss_kb, threads
+ *                  ns_per_op      → Wall time of one operation.
+ *                  digits_per_sec → n / (time per operation): throughput in operand digits.
+ *                  peak_rss_kb    → Peak resident memory of the point, operands included.
+ *
+ * Notes        :
+ *                • Each point runs in its own forked child and the parent reads the child's peak RSS from wait4(), so
+ *                  memory of one point never inflates the next.
+ *                • Repetitions grow until one timed batch lasts --time, so timer overhead stays out of sub-microsecond points.
+ *                • Results follow the build flags of the objects (the default build is unoptimized, like apc.out).
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define DIGITS_PER_LIMB 9.632959861247398     /* log10( 2^32 ) */
+
+typedef enum
+{
+	OP_ADD,
+	OP_SUB,
+	OP_MUL,
+	OP_DIV,
+	OP_POW,
+	OP_PARSE,
+	OP_PRINT,
+	OP_COUNT
+} Bench_op;
+
+static const char *op_names[ OP_COUNT ] = { "add", "sub", "mul", "div", "pow", "parse", "print" };
+
+/* Operands and output of one point */
+typedef struct
+{
+	Bench_op op;
+	size_t digits;
+	Bignum a, b, result;
+	char *text;
+} Bench_point;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static limb_t random_limb( void )
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+
+	return (limb_t) rng_state;
+}
+
+static double now( void )
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static size_t digits_to_limbs( size_t digits )
+{
+	size_t limbs = (size_t) ceil( (double) digits / DIGITS_PER_LIMB );
+	return limbs ? limbs : 1;
+}
+
+/* Random number of exactly the given limb count */
+static Status random_number( Bignum *num, size_t limbs )
+{
+	if( reserve_number( num, limbs ) != SUCCESS )
+		return FAILURE;
+
+	for( size_t i = 0; i < limbs; i++ )
+		num -> limbs[i] = random_limb();
+	num -> limbs[ limbs - 1 ] |= 1;
+	num -> len = limbs;
+
+	return SUCCESS;
+}
+
+static Status setup_point( Bench_point *pt )
+{
+	size_t n = digits_to_limbs( pt -> digits );
+
+	switch( pt -> op )
+	{
+		case OP_ADD:
+		case OP_MUL:
+			if( random_number( &pt -> a, n ) != SUCCESS || random_number( &pt -> b, n ) != SUCCESS )
+				return FAILURE;
+			break;
+
+		case OP_SUB:
+			if( random_number( &pt -> a, n ) != SUCCESS || random_number( &pt -> b, ( n + 1 ) / 2 ) != SUCCESS )
+				return FAILURE;
+			// a > b as subtraction() requires: a's top bit is set, and a b of the same length (n = 1) has it clear
+			pt -> a.limbs[ n - 1 ] |= 0x80000000u;
+			if( pt -> b.len == n )
+				pt -> b.limbs[ n - 1 ] &= 0x7fffffffu;
+			break;
+
+		case OP_DIV:
+			if( random_number( &pt -> a, 2 * n ) != SUCCESS || random_number( &pt -> b, n ) != SUCCESS )
+				return FAILURE;
+			break;
+
+		case OP_POW:
+		{
+			// 3^e has floor( e · log10( 3 ) ) + 1 digits
+			limb_t e = (limb_t) ( (double) pt -> digits / log10( 3.0 ) );
+			if( set_number_word( &pt -> a, 3 ) != SUCCESS || set_number_word( &pt -> b, e ? e : 1 ) != SUCCESS )
+				return FAILURE;
+			break;
+		}
+
+		case OP_PARSE:
+			pt -> text = malloc( pt -> digits + 1 );
+			if( pt -> text == NULL )
+				return FAILURE;
+			for( size_t i = 0; i < pt -> digits; i++ )
+				pt -> text[i] = (char) ( '0' + random_limb() % 10 );
+			pt -> text[0] = '1';
+			pt -> text[ pt -> digits ] = '\0';
+			break;
+
+		case OP_PRINT:
+			// Random digits parsed once give a number of exactly pt -> digits digits
+			pt -> op = OP_PARSE;
+			if( setup_point( pt ) != SUCCESS || decimal_to_number( &pt -> a, pt -> text, pt -> digits ) != SUCCESS )
+				return FAILURE;
+			pt -> op = OP_PRINT;
+			break;
+
+		default:
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+static Status run_once( Bench_point *pt )
+{
+	switch( pt -> op )
+	{
+		case OP_ADD:   return addition( &pt -> a, &pt -> b, &pt -> result );
+		case OP_SUB:   return subtraction( &pt -> a, &pt -> b, &pt -> result );
+		case OP_MUL:   return multiplication( &pt -> a, &pt -> b, &pt -> result );
+		case OP_DIV:   return division( &pt -> a, &pt -> b, &pt -> result, "Div" );
+		case OP_POW:   return power( &pt -> a, &pt -> b, &pt -> result );
+		case OP_PARSE: return decimal_to_number( &pt -> result, pt -> text, pt -> digits );
+		case OP_PRINT: return number_to_decimal( &pt -> a, pt -> text, pt -> digits );
+		default:       return FAILURE;
+	}
+}
+
+/* Child side: time one point and write "reps seconds" to fd */
+static int measure_point( Bench_op op, size_t digits, double min_time, int fd )
+{
+	Bench_point pt = { .op = op, .digits = digits };
+
+	apc_arena_begin();
+
+	if( setup_point( &pt ) != SUCCESS )
+		return 1;
+
+	size_t reps = 1;
+	double elapsed;
+
+	for( ;; )
+	{
+		double start = now();
+		for( size_t r = 0; r < reps; r++ )
+		{
+			if( run_once( &pt ) != SUCCESS )
+				return 1;
+		}
+		elapsed = now() - start;
+
+		if( elapsed >= min_time || reps >= ( (size_t) 1 << 30 ) )
+			break;
+
+		// Aim straight at the time budget once a batch is long enough to trust, doubling until then
+		if( elapsed > min_time / 64 )
+			reps = (size_t) ( reps * min_time / elapsed * 1.1 ) + 1;
+		else
+			reps *= 2;
+	}
+
+	dprintf( fd, "%zu %.9f\n", reps, elapsed );
+	return 0;
+}
+
+typedef struct
+{
+	int json;
+	size_t min_digits, max_digits;
+	double min_time;
+	unsigned ops;		// Bit per Bench_op
+	FILE *out;
+	size_t records;
+} Bench_config;
+
+static void print_record( Bench_config *cfg, Bench_op op, size_t digits, size_t reps, double seconds, long rss_kb )
+{
+	double ns = seconds / (double) reps * 1e9;
+	double rate = (double) digits / ( ns * 1e-9 );
+	size_t threads = parallel_threads();
+
+	if( cfg -> json )
+		fprintf( cfg -> out, "%s  {\"op\": \"%s\", \"digits\": %zu, \"limbs\": %zu, \"reps\": %zu, \"ns_per_op\": %.1f, "
+				 "\"digits_per_sec\": %.4g, \"peak_rss_kb\": %ld, \"threads\": %zu}",
+				 cfg -> records ? ",\n" : "", op_names[op], digits, digits_to_limbs( digits ), reps, ns, rate, rss_kb, threads );
+	else
+		fprintf( cfg -> out, "%s,%zu,%zu,%zu,%.1f,%.4g,%ld,%zu\n",
+				 op_names[op], digits, digits_to_limbs( digits ), reps, ns, rate, rss_kb, threads );
+
+	fflush( cfg -> out );
+	cfg -> records++;
+}
+
+/* Parent side: run one point in a child process and record its time and peak RSS */
+static Status bench_point( Bench_config *cfg, Bench_op op, size_t digits )
+{
+	int fds[2];
+	if( pipe( fds ) != 0 )
+	{
+		perror("INFO : Cannot create pipe");
+		return FAILURE;
+	}
+
+	fflush( NULL );
+	pid_t pid = fork();
+	if( pid < 0 )
+	{
+		perror("INFO : Cannot fork");
+		close( fds[0] );
+		close( fds[1] );
+		return FAILURE;
+	}
+
+	if( pid == 0 )
+	{
+		close( fds[0] );
+		_exit( measure_point( op, digits, cfg -> min_time, fds[1] ) );
+	}
+
+	close( fds[1] );
+
+	char buf[64] = { 0 };
+	ssize_t got = read( fds[0], buf, sizeof( buf ) - 1 );
+	close( fds[0] );
+
+	int wstatus;
+	struct rusage usage;
+	if( wait4( pid, &wstatus, 0, &usage ) < 0 )
+	{
+		perror("INFO : Cannot wait for benchmark child");
+		return FAILURE;
+	}
+
+	size_t reps;
+	double seconds;
+	if( got <= 0 || !WIFEXITED( wstatus ) || WEXITSTATUS( wstatus ) != 0 || sscanf( buf, "%zu %lf", &reps, &seconds ) != 2 )
+	{
+		fprintf( stderr, "INFO : %s at %zu digits failed\n", op_names[op], digits );
+		return FAILURE;
+	}
+
+	// Linux reports ru_maxrss in kilobytes
+	print_record( cfg, op, digits, reps, seconds, usage.ru_maxrss );
+	fprintf( stderr, "%-6s %10zu digits  %14.1f ns/op\n", op_names[op], digits, seconds / (double) reps * 1e9 );
+
+	return SUCCESS;
+}
+
+static unsigned parse_ops( char *list )
+{
+	unsigned ops = 0;
+
+	for( char *name = strtok( list, "," ); name; name = strtok( NULL, "," ) )
+	{
+		int k;
+		for( k = 0; k < OP_COUNT && strcmp( name, op_names[k] ) != 0; k++ )
+			;
+		if( k == OP_COUNT )
+			return 0;
+		ops |= 1u << k;
+	}
+
+	return ops;
+}
+
+int main( int argc, char *argv[] )
+{
+	Bench_config cfg = { 0, 10, 10000000, 0.2, ( 1u << OP_COUNT ) - 1, stdout, 0 };
+
+	for( int i = 1; i < argc; i++ )
+	{
+		int more = ( i + 1 < argc );
+
+		if( strcmp( argv[i], "--json" ) == 0 )
+			cfg.json = 1;
+		else if( strcmp( argv[i], "--min" ) == 0 && more )
+			cfg.min_digits = (size_t) atol( argv[++i] );
+		else if( strcmp( argv[i], "--max" ) == 0 && more )
+			cfg.max_digits = (size_t) atol( argv[++i] );
+		else if( strcmp( argv[i], "--time" ) == 0 && more )
+			cfg.min_time = atof( argv[++i] );
+		else if( strcmp( argv[i], "--ops" ) == 0 && more )
+			cfg.ops = parse_ops( argv[++i] );
+		else if( strcmp( argv[i], "-j" ) == 0 && more )
+			mul_threads = (size_t) atol( argv[++i] );
+		else if( strcmp( argv[i], "-o" ) == 0 && more )
+		{
+			cfg.out = fopen( argv[++i], "w" );
+			if( cfg.out == NULL )
+			{
+				perror("INFO : Cannot open output file");
+				return FAILURE;
+			}
+		}
+		else
+			cfg.ops = 0;
+
+		if( cfg.ops == 0 || cfg.min_digits == 0 || cfg.max_digits < cfg.min_digits )
+		{
+			printf("Format : ./apc_bench [--json] [--min digits] [--max digits] [--time seconds] [--ops add,sub,mul,div,pow,parse,print] [-j threads] [-o file]\n");
+			return FAILURE;
+		}
+	}
+
+	if( cfg.json )
+		fprintf( cfg.out, "[\n" );
+	else
+		fprintf( cfg.out, "op,digits,limbs,reps,ns_per_op,digits_per_sec,peak_rss_kb,threads\n" );
+
+	Status status = SUCCESS;
+
+	// Sizes 1 and 3 per decade: 10, 30, 100, 300, ...
+	for( int op = 0; op < OP_COUNT; op++ )
+	{
+		if( !( cfg.ops & ( 1u << op ) ) )
+			continue;
+
+		for( size_t decade = 1; decade <= cfg.max_digits && decade <= SIZE_MAX / 10; decade *= 10 )
+		{
+			for( size_t step = 1; step <= 3; step += 2 )
+			{
+				size_t digits = decade * step;
+				if( digits < cfg.min_digits || digits > cfg.max_digits )
+					continue;
+
+				if( bench_point( &cfg, (Bench_op) op, digits ) != SUCCESS )
+					status = FAILURE;
+			}
+		}
+	}
+
+	if( cfg.json )
+		fprintf( cfg.out, "\n]\n" );
+
+	if( cfg.out != stdout )
+		fclose( cfg.out );
+
+	return status;
+}
\ No newline at end of file
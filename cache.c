@@ -0,0 +1,438 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : cache_enable / cache_apply / cache_decimal / cache_report
+ * Description      : Optional result cache in front of multiplication(), division() and power() (and mod_power()). Results
+ *                    are addressed by their content: the key is the operator with a hash of the operand magnitudes, and a
+ *                    hit copies the stored magnitude instead of computing it again. Entries live in one process-wide table
+ *                    with a least-recently-used list and a memory budget, so every batch worker and every server connection
+ *                    shares what the others computed; "2 ^ 1000000" is computed once and copied from then on.
+ *                    cache_decimal() does the same for the decimal text of a result, keyed on the result itself: converting
+ *                    a large result to decimal costs more than computing it, so a repeated answer skips both.
+ *
+ * Prototype        : Status cache_enable( size_t budget );
+ *                    Status cache_apply( char operator, const Bignum *num1, const Bignum *num2, const Bignum *num3,
+ *                                        Bignum *result, Divmod_memo *memo );
+ *                    char *cache_decimal( const Bignum *num );
+ *                    Status cache_report( FILE *out );
+ *
+ * Input Parameters : budget     -> Bytes the cached operands, results and entry headers may occupy together.
+ *                    operator   -> 'x', '/', '%' or '^'; num3 is the modulus of a modular power, NULL otherwise.
+ *                    num1..num3 -> Operand magnitudes (signs are resolved by apply_operator(), the cache never sees them).
+ *                    result     -> Number receiving the magnitude, a different number from the operands.
+ *                    memo       -> Optional divmod memo, used for '/' and '%' on a miss exactly as apply_operator() would.
+ *                    num        -> cache_decimal(): Magnitude to print.
+ *                    out        -> Stream receiving the counters as JSON.
+ *
+ * Return Value     : cache_enable  -> SUCCESS, or FAILURE when the cache is already on or its table could not be allocated.
+ *                    cache_apply   -> Status of the operation, the same as calling the arithmetic function directly.
+ *                    cache_decimal -> Decimal digits in a malloc()'d string, as Number_to_string(); NULL on failure.
+ *                    cache_report  -> SUCCESS, or FAILURE when the cache was never enabled.
+ *
+ * Algorithm        :
+ *                    1. Small operations are computed directly: hashing and locking would cost as much as a product or a
+ *                       division whose smaller operand has fewer than CACHE_MIN_LIMBS limbs. Powers are always looked up,
+ *                       their cost does not show in the size of their operands.
+ *                    2. Hash the operand limbs (64-bit FNV-1a over whole limbs) outside the lock.
+ *                    3. Lookup: under the lock, find the entry with the same hash, operator and operand lengths, move it
+ *                       to the front of the recency list and pin it. Then, without the lock, compare every operand limb
+ *                       (a hash collision can never return a wrong result) and copy the result out. Unpinning takes the
+ *                       lock once more.
+ *                    4. Miss: compute without the lock, copy operands and result into one malloc() block, then take the
+ *                       lock only to link it in, evicting from the least recently used end until the budget holds it. A
+ *                       division miss through the memo stores the quotient and the remainder, since both were computed.
+ *
+ * Output Format    :
+ *                    { "cache": { "budget_bytes", "used_bytes", "entries", "hits", "misses", "stores", "evictions" } }
+ *
+ * Notes            :
+ *                    • Disabled (the default), cache_apply() only dispatches to the arithmetic function and cache_decimal()
+ *                      only calls Number_to_string().
+ *                    • Enable it before any worker thread starts. One mutex guards the table and the recency list, and is
+ *                      only held for O(1) bookkeeping (plus a chain walk); limbs and text are never copied under it.
+ *                    • An entry evicted while a reader has it pinned is unlinked at once and freed by its last reader, so
+ *                      memory can exceed the budget for the duration of those copies.
+ *                    • An entry larger than the whole budget is not stored.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <pthread.h>
+
+#define FNV_OFFSET  0xcbf29ce484222325ull
+#define FNV_PRIME   0x100000001b3ull
+
+/* Operands and result stored back to back in limbs: num1, num2, num3 (len 0 when absent), result; a decimal entry
+   ('D') holds its number as num1 and the text behind it */
+typedef struct Cache_entry
+{
+	uint64_t hash;
+	char op;							// Operator, 'M' for a modular power, 'D' for decimal text
+	size_t len[4];
+	size_t bytes;						// Charged against the budget
+	unsigned pins;						// Readers copying out of the entry without the lock
+	int evicted;						// Unlinked while pinned, the last reader frees it
+	struct Cache_entry *chain;			// Next entry in the same bucket
+	struct Cache_entry *newer, *older;	// Recency list
+	limb_t limbs[];
+} Cache_entry;
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static int enabled;
+
+static Cache_entry **buckets;
+static size_t bucket_count, entry_count;
+static Cache_entry *newest, *oldest;
+
+static size_t budget_bytes, used_bytes;
+static uint64_t hits, misses, stores, evictions;
+
+Status cache_enable( size_t budget )
+{
+	// A second table would leak the first
+	if( enabled )
+		return FAILURE;
+
+	bucket_count = 1024;
+	buckets = calloc( bucket_count, sizeof( Cache_entry * ) );
+	if( buckets == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+
+	budget_bytes = budget;
+	enabled = 1;
+
+	return SUCCESS;
+}
+
+/* Arithmetic behind one cache key */
+static Status compute( char operator, const Bignum *num1, const Bignum *num2, const Bignum *num3, Bignum *result,
+					   Divmod_memo *memo )
+{
+	switch( operator )
+	{
+		case 'x':
+			return multiplication( num1, num2, result );
+
+		case '/':
+		case '%':
+			if( memo )
+				return divmod_cached( memo, num1, num2, result, operator == '/' );
+			return division( num1, num2, result, operator == '/' ? "Div" : "Mod" );
+
+		default:
+			return num3 ? mod_power( num1, num2, num3, result ) : power( num1, num2, result );
+	}
+}
+
+static uint64_t hash_number( uint64_t h, const Bignum *num )
+{
+	h = ( h ^ num -> len ) * FNV_PRIME;
+
+	for( size_t i = 0; i < num -> len; i++ )
+		h = ( h ^ num -> limbs[i] ) * FNV_PRIME;
+
+	return h;
+}
+
+/* Same hash, operator and operand lengths: O(1), checked under the lock */
+static int same_key( const Cache_entry *e, uint64_t hash, char op, const Bignum *operand[3] )
+{
+	if( e -> hash != hash || e -> op != op )
+		return 0;
+
+	for( int i = 0; i < 3; i++ )
+		if( e -> len[i] != ( operand[i] ? operand[i] -> len : 0 ) )
+			return 0;
+
+	return 1;
+}
+
+/* Every operand limb equal: O(n), checked on a pinned entry without the lock */
+static int same_operands( const Cache_entry *e, const Bignum *operand[3] )
+{
+	const limb_t *limbs = e -> limbs;
+	for( int i = 0; i < 3; i++ )
+	{
+		if( e -> len[i] && memcmp( limbs, operand[i] -> limbs, e -> len[i] * sizeof( limb_t ) ) != 0 )
+			return 0;
+		limbs += e -> len[i];
+	}
+
+	return 1;
+}
+
+/* Recency list, callers hold the lock */
+static void unlink_recent( Cache_entry *e )
+{
+	if( e -> newer )
+		e -> newer -> older = e -> older;
+	else
+		newest = e -> older;
+
+	if( e -> older )
+		e -> older -> newer = e -> newer;
+	else
+		oldest = e -> newer;
+}
+
+static void push_recent( Cache_entry *e )
+{
+	e -> newer = NULL;
+	e -> older = newest;
+	if( newest )
+		newest -> newer = e;
+	else
+		oldest = e;
+	newest = e;
+}
+
+static void evict_oldest( void )
+{
+	Cache_entry *e = oldest, **link = &buckets[ e -> hash & ( bucket_count - 1 ) ];
+
+	while( *link != e )
+		link = &( *link ) -> chain;
+	*link = e -> chain;
+
+	unlink_recent( e );
+	used_bytes -= e -> bytes;
+	entry_count--;
+	evictions++;
+
+	// A reader still copying out of it frees it when done
+	if( e -> pins )
+		e -> evicted = 1;
+	else
+		free( e );
+}
+
+/* Doubles the bucket array once the chains average one entry; a failed grow keeps the old table */
+static void grow_table( void )
+{
+	size_t count = bucket_count * 2;
+	Cache_entry **table = calloc( count, sizeof( Cache_entry * ) );
+	if( table == NULL )
+		return;
+
+	for( size_t i = 0; i < bucket_count; i++ )
+		while( buckets[i] )
+		{
+			Cache_entry *e = buckets[i];
+			buckets[i] = e -> chain;
+			e -> chain = table[ e -> hash & ( count - 1 ) ];
+			table[ e -> hash & ( count - 1 ) ] = e;
+		}
+
+	free( buckets );
+	buckets = table;
+	bucket_count = count;
+}
+
+/* Finds the entry of a key, marks it most recently used and pins it, so it stays valid after the lock is released.
+   Entries never change once linked, so a pinned entry is read without the lock. */
+static Cache_entry *pin( uint64_t hash, char op, const Bignum *operand[3] )
+{
+	pthread_mutex_lock( &cache_lock );
+
+	Cache_entry *e = buckets[ hash & ( bucket_count - 1 ) ];
+	while( e && !same_key( e, hash, op, operand ) )
+		e = e -> chain;
+
+	if( e )
+	{
+		unlink_recent( e );
+		push_recent( e );
+		e -> pins++;
+	}
+	else
+		misses++;
+
+	pthread_mutex_unlock( &cache_lock );
+
+	return e;
+}
+
+/* Releases a pinned entry and counts the lookup; hit = 0 when the operands only collided on the hash */
+static void unpin( Cache_entry *e, int hit )
+{
+	pthread_mutex_lock( &cache_lock );
+
+	if( hit )
+		hits++;
+	else
+		misses++;
+
+	if( --e -> pins == 0 && e -> evicted )
+		free( e );
+
+	pthread_mutex_unlock( &cache_lock );
+}
+
+/* Copies operands and result (a number, or decimal text) into a new entry and links it in, unless it exceeds the
+   budget or is already there */
+static void store( uint64_t hash, char op, const Bignum *operand[3], const Bignum *result, const char *text )
+{
+	size_t limbs = result ? result -> len : 0,
+		   text_len = text ? strlen( text ) + 1 : 0;
+	for( int i = 0; i < 3; i++ )
+		limbs += operand[i] ? operand[i] -> len : 0;
+
+	size_t bytes = sizeof( Cache_entry ) + limbs * sizeof( limb_t ) + text_len;
+	if( bytes > budget_bytes )
+		return;
+
+	Cache_entry *e = malloc( bytes );
+	if( e == NULL )
+		return;
+
+	e -> hash = hash;
+	e -> op = op;
+	e -> bytes = bytes;
+	e -> pins = 0;
+	e -> evicted = 0;
+
+	limb_t *dst = e -> limbs;
+	for( int i = 0; i < 4; i++ )
+	{
+		const Bignum *num = ( i < 3 ) ? operand[i] : result;
+		e -> len[i] = num ? num -> len : 0;
+		if( e -> len[i] )
+			memcpy( dst, num -> limbs, e -> len[i] * sizeof( limb_t ) );
+		dst += e -> len[i];
+	}
+
+	if( text )
+		memcpy( dst, text, text_len );
+
+	pthread_mutex_lock( &cache_lock );
+
+	// Another thread may have stored the same key while this one was computing (an entry that only collides with it
+	// keeps its place, which costs this store and never a wrong answer)
+	for( Cache_entry *c = buckets[ hash & ( bucket_count - 1 ) ]; c; c = c -> chain )
+		if( same_key( c, hash, op, operand ) )
+		{
+			pthread_mutex_unlock( &cache_lock );
+			free( e );
+			return;
+		}
+
+	while( used_bytes + bytes > budget_bytes )
+		evict_oldest();
+
+	if( entry_count >= bucket_count )
+		grow_table();
+
+	Cache_entry **bucket = &buckets[ hash & ( bucket_count - 1 ) ];
+	e -> chain = *bucket;
+	*bucket = e;
+	push_recent( e );
+
+	used_bytes += bytes;
+	entry_count++;
+	stores++;
+
+	pthread_mutex_unlock( &cache_lock );
+}
+
+static uint64_t hash_key( char op, const Bignum *operand[3] )
+{
+	uint64_t h = ( FNV_OFFSET ^ (unsigned char) op ) * FNV_PRIME;
+
+	for( int i = 0; i < 3; i++ )
+		if( operand[i] )
+			h = hash_number( h, operand[i] );
+
+	return h;
+}
+
+Status cache_apply( char operator, const Bignum *num1, const Bignum *num2, const Bignum *num3, Bignum *result,
+					Divmod_memo *memo )
+{
+	// 1. Disabled, or cheaper to compute than to look up
+	if( !enabled || ( operator != '^' && ( num1 -> len < CACHE_MIN_LIMBS || num2 -> len < CACHE_MIN_LIMBS ) ) )
+		return compute( operator, num1, num2, num3, result, memo );
+
+	// 2. Key
+	char op = num3 ? 'M' : operator;
+	const Bignum *operand[3] = { num1, num2, num3 };
+	uint64_t hash = hash_key( op, operand );
+
+	// 3. Lookup: compare and copy outside the lock
+	Cache_entry *e = pin( hash, op, operand );
+	if( e )
+	{
+		int hit = same_operands( e, operand );
+		Status status = SUCCESS;
+
+		if( hit )
+		{
+			Bignum stored = { e -> limbs + e -> len[0] + e -> len[1] + e -> len[2], e -> len[3], e -> len[3] };
+			status = copy_number( &stored, result );
+		}
+
+		unpin( e, hit );
+		if( hit )
+			return status;
+	}
+
+	// 4. Compute and remember
+	Status status = compute( operator, num1, num2, num3, result, memo );
+	if( status != SUCCESS )
+		return status;
+
+	if( memo && ( operator == '/' || operator == '%' ) && memo -> valid )
+	{
+		store( hash_key( '/', operand ), '/', operand, &memo -> quot, NULL );
+		store( hash_key( '%', operand ), '%', operand, &memo -> rem, NULL );
+	}
+	else
+		store( hash, op, operand, result, NULL );
+
+	return SUCCESS;
+}
+
+char *cache_decimal( const Bignum *num )
+{
+	if( !enabled || num -> len < CACHE_MIN_LIMBS )
+		return Number_to_string( num );
+
+	const Bignum *operand[3] = { num, NULL, NULL };
+	uint64_t hash = hash_key( 'D', operand );
+
+	Cache_entry *e = pin( hash, 'D', operand );
+	if( e )
+	{
+		int hit = same_operands( e, operand );
+		char *digits = NULL;
+
+		if( hit && ( digits = strdup( (const char *) ( e -> limbs + e -> len[0] ) ) ) == NULL )
+			perror("INFO : Memory Allocation Failed");
+
+		unpin( e, hit );
+		if( hit )
+			return digits;
+	}
+
+	char *digits = Number_to_string( num );
+	if( digits )
+		store( hash, 'D', operand, NULL, digits );
+
+	return digits;
+}
+
+Status cache_report( FILE *out )
+{
+	if( !enabled )
+		return FAILURE;
+
+	pthread_mutex_lock( &cache_lock );
+
+	fprintf( out, "{ \"cache\": { \"budget_bytes\": %zu, \"used_bytes\": %zu, \"entries\": %zu, \"hits\": %llu, "
+				  "\"misses\": %llu, \"stores\": %llu, \"evictions\": %llu } }\n",
+			 budget_bytes, used_bytes, entry_count, (unsigned long long) hits, (unsigned long long) misses,
+			 (unsigned long long) stores, (unsigned long long) evictions );
+
+	pthread_mutex_unlock( &cache_lock );
+
+	return SUCCESS;
+}
\ No newline at end of file
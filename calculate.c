@@ -0,0 +1,242 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : calculate / apply_operator
+ * Description      : Evaluates one calculation given in command-line layout (argv[1] operand, argv[2] operator, argv[3] operand,
+ *                    and optionally argv[4] "%" with argv[5] modulus). The operands are converted into the caller's Bignums,
+ *                    the operand signs are resolved into a magnitude operation plus a final sign, and the matching arithmetic
+ *                    function is called. Shared by the single-shot command line in main() and by batch mode, so every
+ *                    front end follows exactly the same sign rules.
+ *                    apply_operator() is the sign-resolving half on its own, for callers whose operands are already numbers
+ *                    (the expression evaluator in expr.c).
+ *
+ * Prototype        : Status calculate( int argc, char *argv[], Bignum *num1, Bignum *num2, Bignum *num3, Bignum *result,
+ *                                      char *final_sign, Divmod_memo *memo );
+ *                    Status apply_operator( char operator, const Bignum *num1, char sign1, const Bignum *num2, char sign2,
+ *                                           const Bignum *num3, char sign3, Bignum *result, char *final_sign,
+ *                                           Divmod_memo *memo );
+ *
+ * Input Parameters : argc, argv -> Calculation tokens, already checked by Validate_arguments(); operands may be "@path".
+ *                    num1, num2 -> Numbers receiving the operands (their limb arrays are reused).
+ *                    num3       -> Number receiving the modulus of "^ ... %" (untouched otherwise).
+ *                    result     -> Number receiving the magnitude of the result.
+ *                    final_sign -> Receives '+' or '-' for the result.
+ *                    memo       -> Optional (NULL for none): '/' and '%' keep both the quotient and the remainder here, so
+ *                                  the other operation on the same magnitudes is answered without dividing again.
+ *                    operator   -> One of + - x / % ^.
+ *                    sign1..3   -> Signs of the three operands; num3 is the modulus of '^', NULL for a plain operation.
+ *                                  The operands are only read, and result must be a different number.
+ *
+ * Return Value     : SUCCESS      -> Result and final sign are set.
+ *                    ZERO_DIVISOR -> Division, modulus or modular power by zero; nothing was computed.
+ *                    NON_NUMERIC  -> An "@path" operand file does not hold a signed decimal number.
+ *                    FAILURE      -> Conversion or memory allocation failed.
+ *
+ * Sign Handling    :
+ *                    • +, -        → Same signs add magnitudes, different signs subtract the smaller from the larger.
+ *                    • x, /, %     → Result is negative exactly when the operand signs differ.
+ *                    • ^           → Negative exponent gives 0; negative base with odd exponent gives a negative result.
+ *                    • ^ ... %     → Sign of the power combined with the modulus sign by the rule of '%'.
+ *
+ * Notes            :
+ *                    • Products, divisions and powers go through cache_apply() (cache.c), which calls the arithmetic
+ *                      function directly unless the result cache was enabled.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+/* Exchanges two operand pointers, so the larger magnitude comes first without touching either number */
+static void Swap_operands( const Bignum **num1, const Bignum **num2 )
+{
+	const Bignum *temp = *num1;
+	*num1 = *num2;
+	*num2 = temp;
+}
+
+Status calculate( int argc, char *argv[], Bignum *num1, Bignum *num2, Bignum *num3, Bignum *result, char *final_sign,
+				  Divmod_memo *memo )
+{
+	char *modulus = ( argc == 6 ) ? argv[5] : NULL;
+
+	/* Convert the Numbers to limb arrays, "@path" operands straight from their mapped files */
+	char sign1 = '+', sign2 = '+', sign3 = '+';
+
+	Status load = load_operand( argv[1], num1, &sign1 );
+	if( load == SUCCESS )
+		load = load_operand( argv[3], num2, &sign2 );
+	if( load == SUCCESS && modulus )
+		load = load_operand( modulus, num3, &sign3 );
+
+	if( load != SUCCESS )
+		return load;
+
+	return apply_operator( argv[2][0], num1, sign1, num2, sign2, modulus ? num3 : NULL, sign3, result, final_sign, memo );
+}
+
+Status apply_operator( char operator, const Bignum *num1, char sign1, const Bignum *num2, char sign2, const Bignum *num3,
+					   char sign3, Bignum *result, char *final_sign, Divmod_memo *memo )
+{
+	/* Division by zero is reported to the caller instead of being computed */
+	if( ( ( operator == '/' || operator == '%' ) && num2 -> len == 0 ) || ( num3 && num3 -> len == 0 ) )
+		return ZERO_DIVISOR;
+
+	Status status = SUCCESS;
+
+	switch ( operator )
+	{
+		case '+':
+			/* call the function to perform the addition operation */
+
+			if( sign1 ==  sign2 )
+			{
+				status = addition( num1, num2, result );
+				*final_sign = sign1;
+			}
+
+			else if( sign1 == '-' )
+			{
+				// (-a) + (b)
+
+				Status larger = Find_largest( num1, num2 );
+				if( larger == LARGE_2 )
+				{
+					Swap_operands( &num1, &num2 );
+					*final_sign = '+';  // b is larger means, result positive
+				}
+				else
+				{
+					*final_sign = '-'; // a is larger means, result negative
+				}
+
+				status = subtraction( num1, num2, result );
+			}
+
+			else if( sign2 == '-' )
+			{
+				// (a) + (-b)
+
+				Status larger = Find_largest( num1, num2 );
+				if( larger == LARGE_2 )
+				{
+					Swap_operands( &num1, &num2 );
+					*final_sign = '-'; // b is larger means, result negative
+				}
+				else
+				{
+					*final_sign = '+'; // a is larger means, result positive
+				}
+
+				status = subtraction( num1, num2, result );
+			}
+			
+			break;
+
+		case '-':	
+			/* call the function to perform the subtraction operation */
+
+			if( sign1 != sign2 )
+			{
+				status = addition( num1, num2, result );
+				*final_sign = sign1;
+			}
+
+			else 
+			{
+				// Same sign: do maginitude based subtraction
+				Status larger = Find_largest( num1, num2 );
+				if( larger == LARGE_2 )
+				{
+					Swap_operands( &num1, &num2 );
+					*final_sign = ( sign1 == '+' ) ? '-': '+'; // Result sign is opposite
+				}
+				else
+				{
+					*final_sign = sign1; // Result sign is same as bigger number
+				}
+
+				status = subtraction( num1, num2, result );
+
+			}
+
+			break;
+
+		case 'x':	
+			/* call the function to perform the multiplication operation */
+
+			status = cache_apply( 'x', num1, num2, NULL, result, NULL );
+
+			if( sign1 == sign2 )
+				*final_sign = '+';
+			else
+				*final_sign = '-';
+
+			break;
+
+		case '/':	
+			/* call the function to perform the division operation */
+
+			status = cache_apply( '/', num1, num2, NULL, result, memo );
+
+			if( sign1 == sign2 )
+				*final_sign = '+';
+			else
+				*final_sign = '-';
+
+			break;
+
+		case '%':	
+			/* call the function to perform the division operation */
+
+			status = cache_apply( '%', num1, num2, NULL, result, memo );
+
+			if( sign1 == sign2 )
+				*final_sign = '+';
+			else
+				*final_sign = '-';
+
+			break;
+
+		case '^': 
+			/// Check for negative exponent (if sign2 == '-'); a zero computed with a sign, like -30 % 5, is not negative
+			if( sign2 == '-' && num2 -> len )
+			{
+				// Result of any base^(-exp) = 0 (integer APC logic)
+				status = set_number_word( result, 0 );
+				*final_sign = '+';
+				break;
+			}
+
+			// Determine sign of result
+			if( sign1 == '+' )
+				*final_sign = '+';
+
+			else
+			{
+				// sign1 is '-', exponent positive → depends on even/odd
+				if( is_exp_even( num2 ) == EVEN )
+					*final_sign = '+';
+
+				else
+					*final_sign = '-';
+			}
+
+			// Modular power: the remainder takes the sign rule of '%'
+			if( num3 )
+			{
+				*final_sign = ( *final_sign == sign3 ) ? '+' : '-';
+
+				status = cache_apply( '^', num1, num2, num3, result, NULL );
+				break;
+			}
+
+			// Perform power normally, exponent is positive
+			status = cache_apply( '^', num1, num2, NULL, result, NULL );
+
+			break;
+
+		default:
+			printf("INFO : Invalid Input:-( Try again...)\n");
+			return FAILURE;
+	}
+
+
+	return status;
+}
\ No newline at end of file
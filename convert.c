@@ -0,0 +1,287 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : decimal_to_number / number_to_decimal
+ * Description      : Radix conversion between decimal text and packed base 2^32 limbs. Short numbers use the quadratic
+ *                    nine-digits-at-a-time loops; long ones are converted divide and conquer over a table of powers
+ *                    P[k] = 10^(9 · 2^k), so the cost follows multiplication (and Newton division) instead of growing with the
+ *                    square of the length. Both directions go through here: parsing operands in String_to_number() and
+ *                    printing results in Number_to_string().
+ *
+ * Prototype        : Status decimal_to_number( Bignum *num, const char *digits, size_t count );
+ *                    Status number_to_decimal( const Bignum *num, char *out, size_t width );
+ *
+ * Input Parameters : num    -> Number receiving the value (parsing) or holding it (printing).
+ *                    digits -> count decimal digits, most significant first, no sign.
+ *                    out    -> Buffer receiving exactly width digits, zero padded on the left (no terminator is written).
+ *                    width  -> Digits to write; must be enough for the value (num < 10^width).
+ *
+ * Return Value     : SUCCESS -> Conversion completed.
+ *                    FAILURE -> Memory allocation failed.
+ *
+ * Algorithm        :
+ *                    1. Parsing, count digits:
+ *                         a. Up to convert_threshold limbs' worth of digits → multiply-and-add by 10^9 per chunk, the
+ *                            chunk values coming from the SIMD digit kernels in digits.c.
+ *                         b. Otherwise split off the low L = 9 · 2^k digits (largest such L below count):
+ *                            value = parse( high digits ) · P[k] + parse( low L digits ).
+ *                    2. Printing, width digits:
+ *                         a. Up to convert_threshold limbs → repeated division by 10^9, nine digits per pass.
+ *                         b. Otherwise take the largest L = 9 · 2^k with 2L <= width, divide once by P[k]:
+ *                            the quotient fills the top width - L digits and the remainder the low L digits.
+ *                    3. P[k] are built once per conversion by repeated squaring, P[k] = P[k - 1]^2. Printing divides by the
+ *                       same P[k] at every node of a level, so large P[k] keep their Newton reciprocal (newton.c) in the table.
+ *
+ * Notes            :
+ *                    • Time Complexity: O(M(n) log n) with M(n) the multiplication cost, in place of O(n^2).
+ *                    • The power table lives only for one conversion, so concurrent conversions share nothing.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+/* Nine-digit chunks converted per parse_chunks() call */
+#define PARSE_BATCH 64
+
+size_t convert_threshold = CONVERT_THRESHOLD;
+
+/* P[k] = 10^(9 · 2^k) for k < count, with the Newton reciprocal of P[k] once printing has needed it */
+typedef struct
+{
+	Bignum P[ 8 * sizeof( size_t ) ];
+	Reciprocal R[ 8 * sizeof( size_t ) ];
+	int has_R[ 8 * sizeof( size_t ) ];
+	size_t count;
+} Power_table;
+
+/* Extend the table up to and including P[k] */
+static Status need_power( Power_table *T, size_t k )
+{
+	if( T -> count == 0 )
+	{
+		init_number( &T -> P[0] );
+		if( set_number_word( &T -> P[0], DEC_CHUNK ) != SUCCESS )
+			return FAILURE;
+		T -> count = 1;
+	}
+
+	while( T -> count <= k )
+	{
+		Bignum *prev = &T -> P[ T -> count - 1 ],
+			   *next = &T -> P[ T -> count ];
+
+		init_number( next );
+		if( multiplication( prev, prev, next ) != SUCCESS )
+			return FAILURE;
+		T -> count++;
+	}
+
+	return SUCCESS;
+}
+
+static void free_powers( Power_table *T )
+{
+	for( size_t k = 0; k < T -> count; k++ )
+	{
+		free_number( &T -> P[k] );
+		if( T -> has_R[k] )
+			reciprocal_free( &T -> R[k] );
+	}
+}
+
+/* quot, rem = num divided by P[k]; large powers are divided through their cached reciprocal */
+static Status divide_power( const Bignum *num, Power_table *T, size_t k, Bignum *quot, Bignum *rem )
+{
+	if( T -> P[k].len < div_newton_threshold )
+		return divide_numbers( num, &T -> P[k], quot, rem );
+
+	if( !T -> has_R[k] )
+	{
+		if( reciprocal_init( &T -> R[k], &T -> P[k] ) != SUCCESS )
+			return FAILURE;
+		T -> has_R[k] = 1;
+	}
+
+	return reciprocal_divide( num, &T -> R[k], quot, rem );
+}
+
+/* Quadratic parse: num = value of count digits */
+static Status parse_basecase( Bignum *num, const char *p, size_t count )
+{
+	num -> len = 0;
+	if( count == 0 )
+		return SUCCESS;
+
+	// Every chunk of nine decimal digits needs at most one limb
+	if( reserve_number( num, count / DEC_CHUNK_DIGITS + 2 ) != SUCCESS )
+		return FAILURE;
+
+	// First chunk takes the leftover digits so that all later chunks are full
+	size_t chunk_len = count % DEC_CHUNK_DIGITS;
+	if( chunk_len == 0 )
+		chunk_len = DEC_CHUNK_DIGITS;
+
+	limb_t chunks[ PARSE_BATCH ];
+	chunks[0] = 0;
+	for( size_t k = 0; k < chunk_len; k++ )
+		chunks[0] = chunks[0] * 10 + (limb_t) ( p[k] - '0' );
+
+	size_t batch = 1;
+	p += chunk_len;
+	count -= chunk_len;
+
+	while( batch )
+	{
+		// num = num * 10^9 + chunk, for every chunk of the batch
+		for( size_t i = 0; i < batch; i++ )
+		{
+			limb_t carry = chunks[i];
+			for( size_t k = 0; k < num -> len; k++ )
+			{
+				dlimb_t t = (dlimb_t) num -> limbs[k] * DEC_CHUNK + carry;
+				num -> limbs[k] = (limb_t) t;
+				carry = (limb_t) ( t >> LIMB_BITS );
+			}
+			if( carry )
+				num -> limbs[ num -> len++ ] = carry;
+		}
+
+		// Full chunks are converted a batch at a time by the vectorized kernel (digits.c)
+		batch = count / DEC_CHUNK_DIGITS < PARSE_BATCH ? count / DEC_CHUNK_DIGITS : PARSE_BATCH;
+		parse_chunks( p, batch, chunks );
+		p += batch * DEC_CHUNK_DIGITS;
+		count -= batch * DEC_CHUNK_DIGITS;
+	}
+
+	return SUCCESS;
+}
+
+static Status parse_recursive( Bignum *num, const char *p, size_t count, Power_table *T )
+{
+	if( count <= convert_threshold * DEC_CHUNK_DIGITS )
+		return parse_basecase( num, p, count );
+
+	// Low part: the largest 9 · 2^k digits below count, so it holds at least half of them
+	size_t k = 0;
+	while( (size_t) DEC_CHUNK_DIGITS << ( k + 1 ) < count )
+		k++;
+	size_t low_len = (size_t) DEC_CHUNK_DIGITS << k;
+
+	Bignum high, low;
+	init_number( &high );
+	init_number( &low );
+
+	Status status = need_power( T, k );
+	if( status == SUCCESS ) status = parse_recursive( &high, p, count - low_len, T );
+	if( status == SUCCESS ) status = parse_recursive( &low, p + count - low_len, low_len, T );
+
+	// num = high · 10^low_len + low
+	if( status == SUCCESS ) status = multiplication( &high, &T -> P[k], num );
+	if( status == SUCCESS )
+		status = add_to( num, &low );
+
+	free_number( &high );
+	free_number( &low );
+
+	return status;
+}
+
+Status decimal_to_number( Bignum *num, const char *digits, size_t count )
+{
+	STAT_SCOPE( STAT_PARSE );
+
+	// Skip leading zeroes, they carry no value
+	while( count && *digits == '0' )
+	{
+		digits++;
+		count--;
+	}
+
+	if( count <= convert_threshold * DEC_CHUNK_DIGITS )
+		return parse_basecase( num, digits, count );
+
+	Power_table T = { .count = 0 };
+	Status status = parse_recursive( num, digits, count, &T );
+	free_powers( &T );
+
+	return status;
+}
+
+/* Quadratic print: exactly width digits of a value below 10^width */
+static Status print_basecase( const Bignum *num, char *out, size_t width )
+{
+	// Work on a scratch copy, dividing by 10^9 peels off nine digits from the right
+	size_t n = num -> len;
+	limb_t *work = apc_alloc( ( n ? n : 1 ) * sizeof( limb_t ) );
+	if( work == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+	if( n )
+		memcpy( work, num -> limbs, n * sizeof( limb_t ) );
+
+	char *p = out + width;
+
+	// Every pass divides by the same 10^9, so its inverse is computed once
+	Word_divisor W;
+	word_divisor_init( &W, DEC_CHUNK );
+
+	while( n )
+	{
+		limb_t rem = div_word_preinv( work, work, n, &W );
+		while( n && work[n - 1] == 0 )
+			n--;
+
+		// Emit the chunk, the last one only as far as it has digits
+		for( int k = 0; k < DEC_CHUNK_DIGITS && ( n || rem ); k++ )
+		{
+			*--p = (char) ( '0' + rem % 10 );
+			rem /= 10;
+		}
+	}
+
+	apc_free( work );
+
+	// Zero padding up to the requested width
+	memset( out, '0', (size_t) ( p - out ) );
+
+	return SUCCESS;
+}
+
+static Status print_recursive( const Bignum *num, char *out, size_t width, Power_table *T )
+{
+	if( num -> len <= convert_threshold || width < 4 * DEC_CHUNK_DIGITS )
+		return print_basecase( num, out, width );
+
+	// Low part: the largest 9 · 2^k digits with twice that still inside width
+	size_t k = 0;
+	while( (size_t) DEC_CHUNK_DIGITS << ( k + 2 ) <= width )
+		k++;
+	size_t low_len = (size_t) DEC_CHUNK_DIGITS << k;
+
+	Bignum quot, rem;
+	init_number( &quot );
+	init_number( &rem );
+
+	Status status = need_power( T, k );
+	if( status == SUCCESS ) status = divide_power( num, T, k, &quot, &rem );
+	if( status == SUCCESS ) status = print_recursive( &quot, out, width - low_len, T );
+	if( status == SUCCESS ) status = print_recursive( &rem, out + width - low_len, low_len, T );
+
+	free_number( &quot );
+	free_number( &rem );
+
+	return status;
+}
+
+Status number_to_decimal( const Bignum *num, char *out, size_t width )
+{
+	STAT_SCOPE( STAT_PRINT );
+
+	if( num -> len <= convert_threshold )
+		return print_basecase( num, out, width );
+
+	Power_table T = { .count = 0, .has_R = { 0 } };
+	Status status = print_recursive( num, out, width, &T );
+	free_powers( &T );
+
+	return status;
+}
\ No newline at end of file
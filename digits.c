@@ -0,0 +1,226 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : check_digits / parse_chunks
+ * Description      : Vectorized digit kernels used on every operand. check_digits() validates a run of ASCII digits and
+ *                    parse_chunks() turns runs of nine digits into base 10^9 chunk values for the radix conversion in
+ *                    convert.c. On x86 the AVX2 kernels take 32 bytes per instruction and the SSE2 kernels 16; the CPU
+ *                    is asked once per call (__builtin_cpu_supports) which one it can run, and everything else falls
+ *                    back to a portable eight-bytes-per-word scan and the plain digit loop.
+ *
+ * Prototype        : int check_digits( const char *p, size_t n );
+ *                    void parse_chunks( const char *p, size_t count, limb_t *chunks );
+ *
+ * Input Parameters : p      -> Digits, most significant first (no sign, no terminator needed).
+ *                    n      -> Bytes to validate.
+ *                    count  -> Chunks to convert; p holds 9 · count valid digits.
+ *                    chunks -> Receives count values below 10^9, most significant first.
+ *
+ * Return Value     : check_digits -> NUMERIC if all n bytes are ASCII digits, NON_NUMERIC otherwise.
+ *
+ * Algorithm        :
+ *                    1. Validation: subtract '0' from every byte; a byte is a digit exactly when the unsigned result is
+ *                       at most 9, i.e. max( byte - '0', 9 ) == 9. One compare mask per 16 or 32 bytes.
+ *                    2. Conversion of 8 digits per 32-bit lane, by pairwise multiply-adds on the digit values:
+ *                         digits → ×10 + → 2-digit pairs → ×100 + → 4-digit groups → ×10000 + → 8-digit values.
+ *                    3. Nine-digit chunks do not line up with 8-digit lanes, so the lanes are re-cut with constant
+ *                       divisions: a block of 36 digits (AVX2: four 8-digit lanes + 4 digits) or 18 digits (SSE2: two
+ *                       lanes + 2 digits) gives exactly 4 or 2 chunks. Loads never read past the block.
+ *                    4. Scalar fallback: high-nibble test on eight bytes per word, one multiply-add per digit.
+ *
+ * Notes            :
+ *                    • Build with -DAPC_NO_SIMD to force the portable kernels (for testing and non-GCC compilers).
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+#if ( defined( __x86_64__ ) || defined( __i386__ ) ) && defined( __GNUC__ ) && !defined( APC_NO_SIMD )
+#define APC_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#define DIGIT_HIGH_MASK 0xF0F0F0F0F0F0F0F0ull
+#define DIGIT_HIGH_3    0x3030303030303030ull
+#define DIGIT_ADD_6     0x0606060606060606ull
+
+/* Portable validation: eight bytes per word, then the tail */
+static int check_digits_scalar( const char *p, size_t n )
+{
+	size_t i = 0;
+
+	for( ; i + 8 <= n; i += 8 )
+	{
+		uint64_t w;
+		memcpy( &w, p + i, sizeof( w ) );
+
+		// High nibble 3 bounds every byte by 0x3F, so adding 6 cannot carry into the next byte
+		if( ( w & DIGIT_HIGH_MASK ) != DIGIT_HIGH_3 || ( ( w + DIGIT_ADD_6 ) & DIGIT_HIGH_MASK ) != DIGIT_HIGH_3 )
+			return NON_NUMERIC;
+	}
+
+	for( ; i < n; i++ )
+	{
+		if( p[i] < '0' || p[i] > '9' )
+			return NON_NUMERIC;
+	}
+
+	return NUMERIC;
+}
+
+/* Value of k < 10 digits */
+static limb_t digits_value( const char *p, size_t k )
+{
+	limb_t v = 0;
+	for( size_t i = 0; i < k; i++ )
+		v = v * 10 + (limb_t) ( p[i] - '0' );
+
+	return v;
+}
+
+static void parse_chunks_scalar( const char *p, size_t count, limb_t *chunks )
+{
+	for( size_t i = 0; i < count; i++ )
+		chunks[i] = digits_value( p + i * DEC_CHUNK_DIGITS, DEC_CHUNK_DIGITS );
+}
+
+#ifdef APC_X86_SIMD
+
+__attribute__(( target( "sse2" ) ))
+static int check_digits_sse2( const char *p, size_t n )
+{
+	const __m128i zero = _mm_set1_epi8( '0' ),
+				  nine = _mm_set1_epi8( 9 );
+	size_t i = 0;
+
+	for( ; i + 16 <= n; i += 16 )
+	{
+		__m128i d = _mm_sub_epi8( _mm_loadu_si128( (const __m128i *) ( p + i ) ), zero );
+		if( _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_max_epu8( d, nine ), nine ) ) != 0xFFFF )
+			return NON_NUMERIC;
+	}
+
+	return check_digits_scalar( p + i, n - i );
+}
+
+__attribute__(( target( "avx2" ) ))
+static int check_digits_avx2( const char *p, size_t n )
+{
+	const __m256i zero = _mm256_set1_epi8( '0' ),
+				  nine = _mm256_set1_epi8( 9 );
+	size_t i = 0;
+
+	for( ; i + 32 <= n; i += 32 )
+	{
+		__m256i d = _mm256_sub_epi8( _mm256_loadu_si256( (const __m256i *) ( p + i ) ), zero );
+		if( (uint32_t) _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_max_epu8( d, nine ), nine ) ) != 0xFFFFFFFFu )
+			return NON_NUMERIC;
+	}
+
+	return check_digits_sse2( p + i, n - i );
+}
+
+/* 16 digits → two 8-digit values; SSE2 has no byte multiply-add, so the digits are widened first */
+__attribute__(( target( "sse2" ) ))
+static void eight_digits_sse2( const char *p, limb_t w[2] )
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i d = _mm_sub_epi8( _mm_loadu_si128( (const __m128i *) p ), _mm_set1_epi8( '0' ) );
+
+	// Element order is memory order, so the more significant digit of each pair takes the larger weight
+	__m128i lo = _mm_madd_epi16( _mm_unpacklo_epi8( d, zero ), _mm_set_epi16( 1, 10, 1, 10, 1, 10, 1, 10 ) ),
+			hi = _mm_madd_epi16( _mm_unpackhi_epi8( d, zero ), _mm_set_epi16( 1, 10, 1, 10, 1, 10, 1, 10 ) );
+
+	__m128i quads = _mm_madd_epi16( _mm_packs_epi32( lo, hi ), _mm_set_epi16( 1, 100, 1, 100, 1, 100, 1, 100 ) );
+	__m128i eights = _mm_madd_epi16( _mm_packs_epi32( quads, quads ), _mm_set_epi16( 1, 10000, 1, 10000, 1, 10000, 1, 10000 ) );
+
+	w[0] = (limb_t) _mm_cvtsi128_si32( eights );
+	w[1] = (limb_t) _mm_cvtsi128_si32( _mm_srli_si128( eights, 4 ) );
+}
+
+/* 32 digits → four 8-digit values; every step stays inside its 128-bit lane */
+__attribute__(( target( "avx2" ) ))
+static void eight_digits_avx2( const char *p, limb_t w[4] )
+{
+	__m256i d = _mm256_sub_epi8( _mm256_loadu_si256( (const __m256i *) p ), _mm256_set1_epi8( '0' ) );
+
+	__m256i pairs = _mm256_maddubs_epi16( d, _mm256_set_epi8( 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10,
+															   1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10 ) );
+	__m256i quads = _mm256_madd_epi16( pairs, _mm256_set1_epi32( ( 1 << 16 ) | 100 ) );
+	__m256i eights = _mm256_madd_epi16( _mm256_packus_epi32( quads, quads ), _mm256_set1_epi32( ( 1 << 16 ) | 10000 ) );
+
+	__m128i low = _mm256_castsi256_si128( eights ),
+			high = _mm256_extracti128_si256( eights, 1 );
+
+	w[0] = (limb_t) _mm_cvtsi128_si32( low );
+	w[1] = (limb_t) _mm_cvtsi128_si32( _mm_srli_si128( low, 4 ) );
+	w[2] = (limb_t) _mm_cvtsi128_si32( high );
+	w[3] = (limb_t) _mm_cvtsi128_si32( _mm_srli_si128( high, 4 ) );
+}
+
+/* Two chunks per 18 digits: lanes d0-7, d8-15 and the digits d16-17 re-cut at 9 and 18 */
+__attribute__(( target( "sse2" ) ))
+static void parse_chunks_sse2( const char *p, size_t count, limb_t *chunks )
+{
+	size_t i = 0;
+
+	for( ; i + 2 <= count; i += 2, p += 2 * DEC_CHUNK_DIGITS )
+	{
+		limb_t w[2];
+		eight_digits_sse2( p, w );
+
+		chunks[i]     = w[0] * 10 + w[1] / 10000000;
+		chunks[i + 1] = ( w[1] % 10000000 ) * 100 + digits_value( p + 16, 2 );
+	}
+
+	parse_chunks_scalar( p, count - i, chunks + i );
+}
+
+/* Four chunks per 36 digits: lanes d0-7 .. d24-31 and the digits d32-35 re-cut at 9, 18, 27 and 36 */
+__attribute__(( target( "avx2" ) ))
+static void parse_chunks_avx2( const char *p, size_t count, limb_t *chunks )
+{
+	size_t i = 0;
+
+	for( ; i + 4 <= count; i += 4, p += 4 * DEC_CHUNK_DIGITS )
+	{
+		limb_t w[4];
+		eight_digits_avx2( p, w );
+
+		chunks[i]     = w[0] * 10 + w[1] / 10000000;
+		chunks[i + 1] = ( w[1] % 10000000 ) * 100 + w[2] / 1000000;
+		chunks[i + 2] = ( w[2] % 1000000 ) * 1000 + w[3] / 100000;
+		chunks[i + 3] = ( w[3] % 100000 ) * 10000 + digits_value( p + 32, 4 );
+	}
+
+	parse_chunks_sse2( p, count - i, chunks + i );
+}
+
+#endif
+
+int check_digits( const char *p, size_t n )
+{
+#ifdef APC_X86_SIMD
+	if( __builtin_cpu_supports( "avx2" ) )
+		return check_digits_avx2( p, n );
+	if( __builtin_cpu_supports( "sse2" ) )
+		return check_digits_sse2( p, n );
+#endif
+
+	return check_digits_scalar( p, n );
+}
+
+void parse_chunks( const char *p, size_t count, limb_t *chunks )
+{
+#ifdef APC_X86_SIMD
+	if( __builtin_cpu_supports( "avx2" ) )
+	{
+		parse_chunks_avx2( p, count, chunks );
+		return;
+	}
+	if( __builtin_cpu_supports( "sse2" ) )
+	{
+		parse_chunks_sse2( p, count, chunks );
+		return;
+	}
+#endif
+
+	parse_chunks_scalar( p, count, chunks );
+}
\ No newline at end of file
@@ -1,197 +1,455 @@
 /*******************************************************************************************************************************************************************
  * Function Name    : division
- * Description      : Performs integer division or modulus operation on two large positive numbers represented as doubly linked lists.
- *                    Each node stores a single digit, with the head being the Most Significant Digit (MSD) and the tail being the
- *                    Least Significant Digit (LSD). The function handles division by zero, magnitude comparison, and repeated
- *                    subtraction-based division while maintaining the result as an arbitrary-precision number list.
+ * Description      : Performs integer division or modulus operation on two large positive numbers represented as packed limb arrays.
+ *                    Each limb stores a base 2^32 digit, with index 0 holding the Least Significant Limb. The function handles
+ *                    division by zero and magnitude comparison, then hands the work to divide_numbers(), which produces the
+ *                    quotient and the remainder together in one pass and keeps the one that was asked for. divmod() hands
+ *                    out both, and divmod_cached() keeps both in a memo so that "a / b" followed by "a % b" divides once.
  *
- * Prototype        : Status division( Dlist **head1, Dlist **tail1,
- *                                     Dlist **head2, Dlist **tail2,
- *                                     Dlist **headR, Dlist **tailR,
- *                                     char *D_or_M );
+ * Prototype        : Status division( const Bignum *num1, const Bignum *num2, Bignum *result, char *D_or_M );
+ *                    Status divmod( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem );
+ *                    Status divmod_cached( Divmod_memo *memo, const Bignum *num1, const Bignum *num2, Bignum *result,
+ *                                          int quotient );
+ *                    void divmod_memo_free( Divmod_memo *memo );
+ *                    Status divmod_small( Bignum *num, limb_t d, limb_t *rem );
+ *                    limb_t div_word( limb_t *q, const limb_t *a, size_t n, limb_t d );
+ *                    void word_divisor_init( Word_divisor *W, limb_t d );
+ *                    limb_t div_word_preinv( limb_t *q, const limb_t *a, size_t n, const Word_divisor *W );
  *
- * Input Parameters : head1, tail1 -> Pointers to the head and tail of the dividend number list.
- *                    head2, tail2 -> Pointers to the head and tail of the divisor number list.
- *                    headR, tailR -> Pointers to the head and tail of the result number list (initially empty).
+ * Input Parameters : num1         -> Dividend.
+ *                    num2         -> Divisor.
+ *                    result       -> Number receiving the quotient or remainder (must not alias num1 or num2).
  *                    D_or_M       -> String indicator specifying operation type:
  *                                      "Div" → Compute and return the quotient.
  *                                      "Mod" → Compute and return the remainder.
+ *                    quot, rem    -> divmod(): Numbers receiving the quotient and the remainder (distinct, no aliasing).
+ *                    memo         -> divmod_cached(): Last operands with their quotient and remainder (zero-filled = empty).
+ *                    quotient     -> divmod_cached(): Non-zero for the quotient, zero for the remainder.
+ *                    num, d, rem  -> divmod_small(): num is divided in place by the machine word d, rem receives num % d.
  *
- * Return Value     : SUCCESS -> Division or modulus completed successfully.
- *                    FAILURE -> If subtraction or node allocation fails during the process.
+ * Return Value     : SUCCESS      -> Division or modulus completed successfully.
+ *                    ZERO_DIVISOR -> Divisor is zero, result is untouched.
+ *                    FAILURE      -> If limb allocation fails during the process.
  *
  * Special Cases    :
- *                    • Divisor = 0 → Displays error and terminates program (division undefined).
+ *                    • Divisor = 0 → Returns ZERO_DIVISOR (division undefined); the caller reports it.
  *                    • Dividend < Divisor → Quotient = 0, Remainder = Dividend.
  *                    • Dividend = Divisor → Quotient = 1, Remainder = 0.
  *
- * Algorithm        :
- *                    1. Check for divide-by-zero and terminate safely if detected.
- *                    2. Compare dividend and divisor:
- *                         - If equal, directly assign result (1 for division, 0 for modulus).
- *                         - If smaller, quotient = 0 or remainder = dividend.
- *                    3. Otherwise, perform repeated subtraction:
- *                         - Subtract divisor from dividend until dividend < divisor.
- *                         - Use increment_list() to maintain an arbitrary-precision quotient.
- *                    4. After the loop:
- *                         - For "Div" → Copy the quotient list into the result.
- *                         - For "Mod" → Copy the remaining dividend into the result.
- *                    5. Remove any leading zeros from the result list.
- *                    6. Free temporary quotient list memory.
+ * Algorithm (divide_numbers):
+ *                    • One-limb divisor                         → div_word(): a single O(n) pass, see below. For "Mod"
+ *                                                                 division() asks it for the remainder only.
+ *                    • Divisor or quotient below div_newton_threshold limbs
+ *                                                              → div_knuth(): Knuth's Algorithm D (schoolbook long division).
+ *                    • Otherwise                                → div_newton() (newton.c): Newton-iteration reciprocal division.
+ *
+ * Algorithm (div_word, one-limb divisor d):
+ *                    • d a power of two → shift right, the remainder is the masked low bits.
+ *                    • Otherwise division by an invariant integer (Möller & Granlund, "Improved division by invariant
+ *                      integers", 2011), no divide instruction in the loop:
+ *                         a. word_divisor_init(): shift d to the top of a 64-bit word and precompute its inverse
+ *                            v = floor((2^128 - 1) / d) - 2^64 (two 64-by-32 bit divisions, once per divisor).
+ *                         b. div_word_preinv(): walk the dividend two limbs at a time; each 128-by-64 bit step takes one
+ *                            64 × 64 bit multiply by v, one by d and a masked correction for the quotient and remainder.
+ *
+ * Algorithm (div_knuth, Knuth Vol. 2, 4.3.1 Algorithm D):
+ *                    1. Normalize: shift divisor and dividend left so the divisor's top limb has its high bit set.
+ *                    2. For each quotient limb from the top:
+ *                         a. Estimate qhat from the top two dividend limbs over the top divisor limb.
+ *                         b. Refine qhat with the second divisor limb (at most two decrements).
+ *                         c. Multiply and subtract qhat × divisor from the current dividend window.
+ *                         d. If the window went negative, decrement qhat and add the divisor back.
+ *                    3. The remaining low limbs, shifted back right, are the remainder.
  *
  * Notes            :
  *                    • This function handles only positive integer division; sign determination is managed externally.
- *                    • The quotient and remainder are both represented as Dlists for arbitrary-precision results.
+ *                    • The quotient and remainder are both represented as Bignums for arbitrary-precision results.
+ *                    • divmod_small() is one div_word() pass over the number itself, with no quotient allocation.
+ *                    • divmod_cached() compares the operands with the memo's (O(n), against an O(n × m) or O(M(n)) division)
+ *                      and copies the stored answer on a match; batch mode keeps one memo per worker.
+ *                    • Callers dividing many numbers by the same limb (decimal printing by 10^9) keep a Word_divisor and
+ *                      call div_word_preinv() directly. About 2× faster than one hardware division per limb.
+ *                    • Time Complexity: O(n × m) for Algorithm D, O(M(n)) per n quotient limbs for the Newton path.
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
 
-Status division( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR , char* D_or_M )
+size_t div_newton_threshold = DIV_NEWTON_THRESHOLD;
+
+Status division( const Bignum *num1, const Bignum *num2, Bignum *result, char* D_or_M )
+{
+	STAT_SCOPE( STAT_DIVISION );
+
+	int quotient = ( D_or_M[0] == 'D' );
+
+	// Divisor zero is reported to the caller, never computed
+	if( num2 -> len == 0 )
+		return ZERO_DIVISOR;
+
+	// One-limb modulus: a single remainder pass, no quotient is stored
+	if( num2 -> len == 1 && !quotient )
+		return set_number_word( result, div_word( NULL, num1 -> limbs, num1 -> len, num2 -> limbs[0] ) );
+
+	Bignum other;
+	init_number( &other );
+
+	Status status;
+
+	if( quotient )
+		status = divmod( num1, num2, result, &other );	// Quotient
+	else
+		status = divmod( num1, num2, &other, result );	// Reminder
+
+	free_number( &other );
+
+	return status;
+}
+
+/* quot = num1 / num2 and rem = num1 % num2 from one division */
+Status divmod( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem )
+{
+	STAT_SCOPE( STAT_DIVMOD );
+
+	if( num2 -> len == 0 )
+		return ZERO_DIVISOR;
+
+	return divide_numbers( num1, num2, quot, rem );
+}
+
+/* result = num1 / num2 (quotient set) or num1 % num2; divides only if the operands differ from the memo's */
+Status divmod_cached( Divmod_memo *memo, const Bignum *num1, const Bignum *num2, Bignum *result, int quotient )
 {
+	if( num2 -> len == 0 )
+		return ZERO_DIVISOR;
 
-	// Check if divisor is zero
-	if( (*head2) -> data == 0 && !(*head2) -> next )
+	if( !memo -> valid || Find_largest( num1, &memo -> num1 ) != EQUAL || Find_largest( num2, &memo -> num2 ) != EQUAL )
 	{
-		printf("INFO: Division by Zero is not possible\n");
-		exit(0);
+		memo -> valid = 0;
+
+		if( divmod( num1, num2, &memo -> quot, &memo -> rem ) != SUCCESS
+			|| copy_number( num1, &memo -> num1 ) != SUCCESS || copy_number( num2, &memo -> num2 ) != SUCCESS )
+			return FAILURE;
+
+		memo -> valid = 1;
 	}
 
+	return copy_number( quotient ? &memo -> quot : &memo -> rem, result );
+}
+
+void divmod_memo_free( Divmod_memo *memo )
+{
+	free_number( &memo -> num1 );
+	free_number( &memo -> num2 );
+	free_number( &memo -> quot );
+	free_number( &memo -> rem );
+	memo -> valid = 0;
+}
+
+/* quot = num1 / num2 and rem = num1 % num2 in one pass, num2 must be non-zero */
+Status divide_numbers( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem )
+{
 	// Get the largest number
-	Status large = Find_largest( *head1, *head2 );
-	
-	// If both numbers are equal return 1
+	Status large = Find_largest( num1, num2 );
+
+	// If both numbers are equal, quotient is 1 and reminder is 0
 	if( large == EQUAL )
 	{
-		if( strstr( D_or_M, "Div" ) )
-			insert_at_last( headR, tailR, 1 ); // Quotient is 1
+		rem -> len = 0;
+		return set_number_word( quot, 1 );
+	}
 
-		else
-			insert_at_last( headR, tailR, 0 ); // Reminder is 0
+	// If divident < divisor, quotient is 0 and reminder is divident
+	if( large == LARGE_2 )
+	{
+		quot -> len = 0;
+		return copy_number( num1, rem );
+	}
+
+	size_t an = num1 -> len,
+		   bn = num2 -> len;
+
+	if( bn >= div_newton_threshold && an - bn >= div_newton_threshold )
+		return div_newton( num1, num2, quot, rem );
+
+	if( reserve_number( quot, an - bn + 1 ) != SUCCESS || reserve_number( rem, bn ) != SUCCESS )
+		return FAILURE;
+
+	if( bn == 1 )
+		rem -> limbs[0] = div_word( quot -> limbs, num1 -> limbs, an, num2 -> limbs[0] );
+
+	else if( div_knuth( quot -> limbs, rem -> limbs, num1 -> limbs, an, num2 -> limbs, bn ) != SUCCESS )
+		return FAILURE;
 
-		return SUCCESS;
+	quot -> len = an - bn + 1;
+	rem -> len = bn;
+
+	// Remove leading zeroes from results
+	trim_number( quot );
+	trim_number( rem );
+
+	return SUCCESS;
+}
+
+/* Two-word product: hi:lo = x × y */
+static inline void mul_64( uint64_t x, uint64_t y, uint64_t *hi, uint64_t *lo )
+{
+#ifdef __SIZEOF_INT128__
+	unsigned __int128 p = (unsigned __int128) x * y;
+	*hi = (uint64_t) ( p >> 64 );
+	*lo = (uint64_t) p;
+#else
+	uint64_t ll = (uint64_t) (uint32_t) x * (uint32_t) y,
+			 lh = (uint64_t) (uint32_t) x * ( y >> 32 ),
+			 hl = ( x >> 32 ) * (uint32_t) y,
+			 hh = ( x >> 32 ) * ( y >> 32 );
+	uint64_t mid = ( ll >> 32 ) + (uint32_t) lh + (uint32_t) hl;
+
+	*lo = ( mid << 32 ) | (uint32_t) ll;
+	*hi = hh + ( lh >> 32 ) + ( hl >> 32 ) + ( mid >> 32 );
+#endif
+}
+
+/* One step of (u1:u0) / d for u1 < d, with d and v from word_divisor_init(): returns the quotient word, *rem the remainder */
+static inline uint64_t div_step( uint64_t u1, uint64_t u0, const Word_divisor *W, uint64_t *rem )
+{
+	uint64_t q1, q0;
+	mul_64( W -> v, u1, &q1, &q0 );
+
+	// (q1:q0) = v · u1 + (u1:u0), then q1 + 1 is the candidate quotient
+	q0 += u0;
+	q1 += u1 + 1 + ( q0 < u0 );
+
+	uint64_t r = u0 - q1 * W -> d;
+
+	// Candidate one too large: taken about half the time, so it is done with a mask instead of a branch
+	uint64_t mask = - (uint64_t) ( r > q0 );
+	q1 += mask;
+	r += mask & W -> d;
+
+	// Candidate one too small: rare
+	if( r >= W -> d )
+	{
+		q1++;
+		r -= W -> d;
 	}
 
-	// If divident < divisor
-	if( large == LARGE_2 )
+	*rem = r;
+	return q1;
+}
+
+/* Limb i of a << shift, taking the bits shifted in from limb i - 1 */
+static inline limb_t shifted_limb( const limb_t *a, size_t i, unsigned shift )
+{
+	if( shift == 0 )
+		return a[i];
+
+	return ( a[i] << shift ) | ( i ? a[i - 1] >> ( LIMB_BITS - shift ) : 0 );
+}
+
+void word_divisor_init( Word_divisor *W, limb_t d )
+{
+	W -> shift = 0;
+	while( !( d & 0x80000000u ) )
 	{
-		if( strstr( D_or_M, "Div" ) )
-			insert_at_last( headR, tailR, 0 ); // Quotient is 0
+		d <<= 1;
+		W -> shift++;
+	}
+
+	// v = floor( (B^4 - 1) / (d · B) ) - B^2 = floor( (B^3 - 1) / d ) - B^2; the top quotient limb is always 1
+	dlimb_t rem = (limb_t) -1 - d,
+			cur = ( rem << LIMB_BITS ) | (limb_t) -1;
+	dlimb_t q1 = cur / d;
+
+	cur = ( ( cur % d ) << LIMB_BITS ) | (limb_t) -1;
+
+	W -> v = ( q1 << LIMB_BITS ) | ( cur / d );
+	W -> d = (dlimb_t) d << LIMB_BITS;
+}
+
+/* Limb kernel: q[0..n) = a / d, returns a % d, with d precomputed by word_divisor_init(). q may alias a, or be NULL for the remainder only. */
+limb_t div_word_preinv( limb_t *q, const limb_t *a, size_t n, const Word_divisor *W )
+{
+	STAT_SCOPE( STAT_DIV_WORD_PREINV );
+
+	if( n == 0 )
+		return 0;
 
-		else
+	unsigned shift = W -> shift;
+
+	// Running remainder of the normalized dividend, in the high half of the word like the divisor
+	dlimb_t r = shift ? a[n - 1] >> ( LIMB_BITS - shift ) : 0,
+			rem;
+	size_t i = n;
+
+	// Odd limb count: the top limb alone, so the rest pairs up
+	if( n & 1 )
+	{
+		i--;
+		dlimb_t qw = div_step( r, (dlimb_t) shifted_limb( a, i, shift ) << LIMB_BITS, W, &rem );
+		if( q )
+			q[i] = (limb_t) qw;
+		r = rem >> LIMB_BITS;
+	}
+
+	// Two limbs per step: (r · B^2 + u1 · B + u0) · B / (d · B) has the same quotient, and its remainder is scaled by B
+	while( i )
+	{
+		i -= 2;
+		dlimb_t u1 = ( r << LIMB_BITS ) | shifted_limb( a, i + 1, shift ),
+				u0 = (dlimb_t) shifted_limb( a, i, shift ) << LIMB_BITS;
+
+		dlimb_t qw = div_step( u1, u0, W, &rem );
+		if( q )
 		{
-			Dlist *temp = *head1;
-			while( temp )
-			{
-				insert_at_last( headR, tailR, temp -> data ); // Reminder is divident
-				temp = temp -> next;
-			}
+			q[i + 1] = (limb_t) ( qw >> LIMB_BITS );
+			q[i] = (limb_t) qw;
 		}
-
-		return SUCCESS;
+		r = rem >> LIMB_BITS;
 	}
 
-	// Repeated subtraction
-	Dlist *qH = NULL, *qT = NULL;
+	return (limb_t) ( r >> shift );
+}
+
+/* Limb kernel: q[0..n) = a / d, returns a % d. q may alias a, or be NULL for the remainder only. */
+limb_t div_word( limb_t *q, const limb_t *a, size_t n, limb_t d )
+{
+	STAT_SCOPE( STAT_DIV_WORD );
 
-	while( ( large = Find_largest( *head1, *head2 ) ) == LARGE_1 )
+	// Power of two: a shift and a mask
+	if( ( d & ( d - 1 ) ) == 0 )
 	{
-		// Clear the current results to avoid wrong results
-		*headR = NULL;
-		*tailR = NULL;
-		
-		if( subtraction( head1, tail1, head2, tail2, headR, tailR ) == FAILURE )
-			return FAILURE;
+		limb_t rem = n ? a[0] & ( d - 1 ) : 0;
 
-		// a = a - b, so Update the divident to new reduced value
-		*head1 = *headR;
-		*tail1 = *tailR;
+		unsigned shift = 0;
+		while( ( (limb_t) 1 << shift ) != d )
+			shift++;
 
-		if( increment_list( &qH, &qT ) == FAILURE ) 
-			return FAILURE;
+		if( q && shift )
+			rshift_limbs( q, a, n, shift );
+		else if( q && q != a )
+			memcpy( q, a, n * sizeof( limb_t ) );
+
+		return rem;
 	}
 
-	// If both numbers are equal after last subtraction, increment quotient by 1
-	if( large == EQUAL )
+	Word_divisor W;
+	word_divisor_init( &W, d );
+
+	return div_word_preinv( q, a, n, &W );
+}
+
+/* Limb kernel: q[0..an-bn] = a / b, r[0..bn) = a % b for an >= bn >= 2 and b[bn-1] != 0 (Algorithm D) */
+Status div_knuth( limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	STAT_SCOPE( STAT_DIV_KNUTH );
+
+	// Normalized copies: u has one extra limb for the bits shifted out of the dividend
+	limb_t *u = apc_alloc( ( an + 1 + bn ) * sizeof( limb_t ) );
+	if( u == NULL )
 	{
-		if( increment_list( &qH, &qT ) == FAILURE ) 
-			return FAILURE;
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+	limb_t *v = u + an + 1;
 
-		*head1 = *tail1 = NULL;
-    	insert_at_last( head1, tail1, 0 );
+	unsigned shift = 0;
+	for( limb_t top = b[bn - 1]; !( top & 0x80000000u ); top <<= 1 )
+		shift++;
+
+	if( shift )
+	{
+		lshift_limbs( v, b, bn, shift );
+		u[an] = lshift_limbs( u, a, an, shift );
+	}
+	else
+	{
+		memcpy( v, b, bn * sizeof( limb_t ) );
+		memcpy( u, a, an * sizeof( limb_t ) );
+		u[an] = 0;
 	}
-	
-	// Prepare the result list based on Div or Mod
-	*headR = NULL;
-	*tailR = NULL;
 
-	if( strstr( D_or_M, "Div" ) )
+	dlimb_t vtop = v[bn - 1],
+			vnext = v[bn - 2];
+
+	for( size_t j = an - bn + 1; j-- > 0; )
 	{
-		// Convert the quotient to result list
-		if( qH == NULL )
-			insert_at_last( headR, tailR, 0 );
-		else
+		// Estimate the quotient limb from the top two limbs of the window
+		dlimb_t num = ( (dlimb_t) u[j + bn] << LIMB_BITS ) | u[j + bn - 1];
+		dlimb_t qhat = num / vtop;
+		dlimb_t rhat = num % vtop;
+
+		while( qhat >> LIMB_BITS || qhat * vnext > ( ( rhat << LIMB_BITS ) | u[j + bn - 2] ) )
 		{
-			Dlist *temp = qH;
-			while( temp )
-			{
-				insert_at_first( headR, tailR, temp -> data );
-				temp = temp -> next;
-			}
+			qhat--;
+			rhat += vtop;
+			if( rhat >> LIMB_BITS )
+				break;
 		}
-	}
-	
-	else if( strstr( D_or_M, "Mod" ) )
-	{
-		// Copy remaining divident digits to result as reminder
-		if( (*head1) -> data == 0 && !(*head1) -> next )
-			insert_at_last( headR, tailR, 0 );
-		else
+
+		// Multiply and subtract qhat × v from the window u[j .. j + bn]
+		limb_t carry = 0, borrow = 0;
+		for( size_t i = 0; i < bn; i++ )
+		{
+			dlimb_t p = qhat * v[i] + carry;
+			carry = (limb_t) ( p >> LIMB_BITS );
+
+			dlimb_t diff = (dlimb_t) u[i + j] - (limb_t) p - borrow;
+			u[i + j] = (limb_t) diff;
+			borrow = (limb_t) ( diff >> LIMB_BITS ) & 1;
+		}
+
+		dlimb_t diff = (dlimb_t) u[j + bn] - carry - borrow;
+		u[j + bn] = (limb_t) diff;
+
+		// Window went negative: qhat was one too large, add the divisor back
+		if( diff >> LIMB_BITS )
 		{
-			Dlist *temp = *head1;
-			while( temp )
-			{
-				insert_at_last( headR, tailR, temp -> data );
-				temp = temp -> next;
-			}
+			qhat--;
+			u[j + bn] += add_limbs( u + j, u + j, bn, v, bn );
 		}
+
+		q[j] = (limb_t) qhat;
 	}
-	
-	free_list( &qH, &qT);
 
-	// Remove leading zeroes from result
-	while( (*headR)->next && (*headR)->data == 0 )
-        delete_at_first( headR, tailR );
+	// Un-normalize the remainder
+	if( shift )
+		rshift_limbs( r, u, bn, shift );
+	else
+		memcpy( r, u, bn * sizeof( limb_t ) );
 
+	apc_free( u );
 	return SUCCESS;
 }
 
-Status increment_list( Dlist **head, Dlist **tail )
+/* In place: num = num / d and *rem = num % d for a machine word d */
+Status divmod_small( Bignum *num, limb_t d, limb_t *rem )
 {
-    if( head == NULL || tail == NULL )
+	if( d == 0 )
+		return ZERO_DIVISOR;
+
+	*rem = div_word( num -> limbs, num -> limbs, num -> len, d );
+	trim_number( num );
+
+	return SUCCESS;
+}
+
+Status increment_number( Bignum *num )
+{
+	if( num == NULL )
 		return FAILURE;
-    
-	if( *head == NULL )
-	{
-        if( insert_at_first( head, tail, 1 ) != SUCCESS )
-			return FAILURE;
-        
-		return SUCCESS;
-    }
 
-    Dlist *t = *tail;
-    int carry = 1;
-    while( t && carry )
-	{
-        int sum = t -> data + carry;
-        t -> data = sum % 10;
-        carry = sum / 10;
-        t = t -> prev;
-    }
-    if( carry )
+	for( size_t i = 0; i < num -> len; i++ )
 	{
-        if( insert_at_first( head, tail, carry ) != SUCCESS )
-			return FAILURE;
-    }
-	
-    return SUCCESS;
+		// Carry stops at the first limb that does not wrap around
+		if( ++num -> limbs[i] != 0 )
+			return SUCCESS;
+	}
+
+	// All limbs wrapped (or number was zero), so a new most significant limb is needed
+	if( reserve_number( num, num -> len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	num -> limbs[ num -> len++ ] = 1;
+
+	return SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,645 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : run_expressions / expr_parse / expr_evaluate / expr_free / env_free
+ * Description      : Expression engine. A statement is tokenized and parsed by precedence climbing into an expression tree,
+ *                    which is evaluated in-process with the same sign rules as the command line (apply_operator()). Named
+ *                    variables keep their values as numbers between statements, so a formula over multi-million-digit
+ *                    intermediates never turns them back into text.
+ *
+ * Prototype        : Status run_expressions( const char *program, FILE *in, FILE *out );
+ *                    Expr_node *expr_parse( const char **text, const Expr_env *env, char *error, size_t error_size );
+ *                    Status expr_evaluate( const Expr_node *node, Expr_env *env, Bignum *scratch, const Bignum **value,
+ *                                          char *sign );
+ *                    void expr_free( Expr_node *node );
+ *                    void env_free( Expr_env *env );
+ *
+ * Input Parameters : program -> Statements to run, NULL to read them line by line from in.
+ *                    out     -> Stream receiving one line per expression statement.
+ *                    text    -> Start of the next statement, advanced past its terminator.
+ *                    env     -> Variables defined so far, NULL to accept any name (the inputs of a compiled plan).
+ *                    error   -> Receives the syntax error message ("" when the statement was empty).
+ *                    scratch -> Number a computed value is built in.
+ *                    value   -> Receives the value: scratch, a number of the tree, or a variable (no copy is made).
+ *                    sign    -> Receives '+' or '-' for the value.
+ *
+ * Return Value     : run_expressions -> SUCCESS if every statement was evaluated, FAILURE otherwise.
+ *                    expr_parse      -> The statement's tree, NULL if it was empty or had a syntax error.
+ *                    expr_evaluate   -> SUCCESS, ZERO_DIVISOR, or FAILURE when memory allocation failed.
+ *
+ * Grammar          :
+ *                    statement  := name "=" statement | expression              (separated by ';' or new lines)
+ *                    expression := expression ( "+" | "-" ) term | term
+ *                    term       := term ( "x" | "*" | "/" | "%" ) unary | unary
+ *                    unary      := ( "-" | "+" ) unary | power
+ *                    power      := primary "^" unary | primary                     (right associative)
+ *                    primary    := digits | "@path" | name | "(" expression ")"
+ *
+ * Output Format    :
+ *                    • Expression  → Plain signed decimal, e.g. "-69104", as in batch mode.
+ *                    • Assignment  → Nothing; the value is kept under its name.
+ *                    • Errors      → "ERROR: Syntax Error near ')'", "ERROR: Undefined Variable 'y'",
+ *                                    "ERROR: Division by Zero", "ERROR: Calculation Failure", "ERROR: Invalid Input".
+ *
+ * Notes            :
+ *                    • "x" is the multiplication operator, as on the command line, so it cannot name a variable.
+ *                    • "a ^ b % m" is evaluated by mod_power(), exactly like the command-line form, and never builds a ^ b.
+ *                    • Literals are converted once while parsing; reading a number or a variable costs no copy.
+ *                    • A failing statement only prints its error line; the statements after it still run.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <ctype.h>
+
+/* Binding strength of the operators; unary signs sit between the products and '^' */
+#define PREC_SUM     1
+#define PREC_PRODUCT 2
+#define PREC_UNARY   3
+#define PREC_POWER   4
+
+typedef enum
+{
+	TOKEN_END,			// ';', new line or end of text
+	TOKEN_NUMBER,
+	TOKEN_FILE,			// "@path" operand
+	TOKEN_NAME,
+	TOKEN_OPERATOR,
+	TOKEN_OPEN,
+	TOKEN_CLOSE,
+	TOKEN_ASSIGN,
+	TOKEN_INVALID
+} Token_kind;
+
+typedef struct
+{
+	Token_kind kind;
+	const char *start;
+	size_t len;
+	char op;			// Operator with '*' folded into 'x'
+} Token;
+
+typedef struct
+{
+	const char *p;		// First character after the current token
+	Token tok;
+	const Expr_env *env;
+	char *error;
+	size_t error_size;
+} Parser;
+
+static void next_token( Parser *P )
+{
+	while( *P -> p == ' ' || *P -> p == '\t' || *P -> p == '\r' )
+		P -> p++;
+
+	Token *t = &P -> tok;
+	const char *p = P -> p;
+	t -> start = p;
+
+	if( *p == '\0' || *p == ';' || *p == '\n' )
+		t -> kind = TOKEN_END;
+	else if( isdigit( (unsigned char) *p ) )
+	{
+		while( isdigit( (unsigned char) *p ) )
+			p++;
+		t -> kind = TOKEN_NUMBER;
+	}
+	else if( *p == '@' )
+	{
+		while( *++p && !isspace( (unsigned char) *p ) && *p != ';' && *p != ')' )
+			;
+		t -> kind = TOKEN_FILE;
+	}
+	else if( isalpha( (unsigned char) *p ) || *p == '_' )
+	{
+		while( isalnum( (unsigned char) *p ) || *p == '_' )
+			p++;
+
+		// A lone "x" is multiplication, as on the command line
+		if( p - t -> start == 1 && *t -> start == 'x' )
+		{
+			t -> kind = TOKEN_OPERATOR;
+			t -> op = 'x';
+		}
+		else
+			t -> kind = TOKEN_NAME;
+	}
+	else if( strchr( "+-*/%^", *p ) )
+	{
+		t -> kind = TOKEN_OPERATOR;
+		t -> op = ( *p == '*' ) ? 'x' : *p;
+		p++;
+	}
+	else
+	{
+		t -> kind = ( *p == '(' ) ? TOKEN_OPEN : ( *p == ')' ) ? TOKEN_CLOSE : ( *p == '=' ) ? TOKEN_ASSIGN : TOKEN_INVALID;
+		p++;
+	}
+
+	t -> len = p - t -> start;
+	P -> p = p;
+}
+
+/* Records the first error of the statement, always returns NULL */
+static Expr_node *parse_error( Parser *P, const char *message, const Token *t )
+{
+	if( P -> error[0] == '\0' )
+	{
+		if( t )
+			snprintf( P -> error, P -> error_size, "%s '%.*s'", message, t -> len > 32 ? 32 : (int) t -> len, t -> start );
+		else
+			snprintf( P -> error, P -> error_size, "%s", message );
+	}
+
+	return NULL;
+}
+
+static Expr_node *new_node( Parser *P, Expr_kind kind )
+{
+	Expr_node *node = calloc( 1, sizeof( Expr_node ) );
+	if( node == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return parse_error( P, "Calculation Failure", NULL );
+	}
+
+	node -> kind = kind;
+	node -> sign = '+';
+	init_number( &node -> value );
+	return node;
+}
+
+static char *copy_text( const char *start, size_t len )
+{
+	char *s = malloc( len + 1 );
+	if( s == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return NULL;
+	}
+
+	memcpy( s, start, len );
+	s[ len ] = '\0';
+	return s;
+}
+
+static Expr_variable *find_variable( const Expr_env *env, const char *name, size_t len )
+{
+	for( size_t i = 0; i < env -> count; i++ )
+		if( strlen( env -> vars[i].name ) == len && memcmp( env -> vars[i].name, name, len ) == 0 )
+			return &env -> vars[i];
+
+	return NULL;
+}
+
+static Expr_node *parse_expression( Parser *P, int min_prec );
+
+static Expr_node *parse_primary( Parser *P )
+{
+	Token t = P -> tok;
+	Expr_node *node;
+
+	switch( t.kind )
+	{
+		case TOKEN_NUMBER:
+			if( ( node = new_node( P, EXPR_NUMBER ) ) == NULL )
+				return NULL;
+
+			next_token( P );
+			if( decimal_to_number( &node -> value, t.start, t.len ) != SUCCESS )
+			{
+				expr_free( node );
+				return parse_error( P, "Calculation Failure", NULL );
+			}
+			return node;
+
+		case TOKEN_FILE:
+		{
+			if( ( node = new_node( P, EXPR_NUMBER ) ) == NULL )
+				return NULL;
+
+			next_token( P );
+			char *path = copy_text( t.start, t.len );
+			Status load = path ? load_operand( path, &node -> value, &node -> sign ) : FAILURE;
+			free( path );
+
+			if( load != SUCCESS )
+			{
+				expr_free( node );
+				return parse_error( P, load == NON_NUMERIC ? "Invalid Input" : "Calculation Failure", NULL );
+			}
+			return node;
+		}
+
+		case TOKEN_NAME:
+			// Statements run one at a time, so a name unknown now is unknown when the tree is evaluated
+			if( P -> env && find_variable( P -> env, t.start, t.len ) == NULL )
+				return parse_error( P, "Undefined Variable", &t );
+
+			if( ( node = new_node( P, EXPR_VARIABLE ) ) == NULL || ( node -> name = copy_text( t.start, t.len ) ) == NULL )
+			{
+				expr_free( node );
+				return parse_error( P, "Calculation Failure", NULL );
+			}
+
+			next_token( P );
+			return node;
+
+		case TOKEN_OPEN:
+			next_token( P );
+			if( ( node = parse_expression( P, PREC_SUM ) ) == NULL )
+				return NULL;
+
+			if( P -> tok.kind != TOKEN_CLOSE )
+			{
+				expr_free( node );
+				return parse_error( P, "Syntax Error: missing ')'", NULL );
+			}
+
+			next_token( P );
+			return node;
+
+		case TOKEN_END:
+			return parse_error( P, "Syntax Error: missing operand", NULL );
+
+		default:
+			return parse_error( P, "Syntax Error near", &t );
+	}
+}
+
+/* Leading signs bind looser than '^': -2 ^ 2 is -(2 ^ 2) */
+static Expr_node *parse_unary( Parser *P )
+{
+	if( P -> tok.kind != TOKEN_OPERATOR || ( P -> tok.op != '-' && P -> tok.op != '+' ) )
+		return parse_primary( P );
+
+	char op = P -> tok.op;
+	next_token( P );
+
+	Expr_node *operand = parse_expression( P, PREC_UNARY );
+	if( operand == NULL || op == '+' )
+		return operand;
+
+	Expr_node *node = new_node( P, EXPR_NEGATE );
+	if( node == NULL )
+	{
+		expr_free( operand );
+		return NULL;
+	}
+
+	node -> left = operand;
+	return node;
+}
+
+static int precedence( char op )
+{
+	switch( op )
+	{
+		case '+':
+		case '-':
+			return PREC_SUM;
+
+		case '^':
+			return PREC_POWER;
+
+		default:
+			return PREC_PRODUCT;
+	}
+}
+
+/* Precedence climbing: folds operators binding at least min_prec into the left operand */
+static Expr_node *parse_expression( Parser *P, int min_prec )
+{
+	Expr_node *left = parse_unary( P );
+
+	while( left && P -> tok.kind == TOKEN_OPERATOR && precedence( P -> tok.op ) >= min_prec )
+	{
+		char op = P -> tok.op;
+		int prec = precedence( op );
+		next_token( P );
+
+		// '^' is right associative, the others left associative
+		Expr_node *right = parse_expression( P, op == '^' ? prec : prec + 1 ),
+				  *node = right ? new_node( P, EXPR_BINARY ) : NULL;
+
+		if( node == NULL )
+		{
+			expr_free( left );
+			expr_free( right );
+			return NULL;
+		}
+
+		node -> op = op;
+		node -> left = left;
+		node -> right = right;
+		left = node;
+	}
+
+	return left;
+}
+
+static Expr_node *parse_statement( Parser *P )
+{
+	// name "=" statement, recognised by looking past the name for '='
+	if( P -> tok.kind == TOKEN_NAME )
+	{
+		const char *q = P -> p;
+		while( *q == ' ' || *q == '\t' )
+			q++;
+
+		if( *q == '=' )
+		{
+			Token name = P -> tok;
+			Expr_node *node = new_node( P, EXPR_ASSIGN );
+			if( node == NULL || ( node -> name = copy_text( name.start, name.len ) ) == NULL )
+			{
+				expr_free( node );
+				return parse_error( P, "Calculation Failure", NULL );
+			}
+
+			next_token( P );
+			next_token( P );
+
+			if( ( node -> left = parse_statement( P ) ) == NULL )
+			{
+				expr_free( node );
+				return NULL;
+			}
+			return node;
+		}
+	}
+
+	return parse_expression( P, PREC_SUM );
+}
+
+Expr_node *expr_parse( const char **text, const Expr_env *env, char *error, size_t error_size )
+{
+	Parser P = { *text, { 0 }, env, error, error_size };
+	error[0] = '\0';
+
+	next_token( &P );
+
+	Expr_node *node = NULL;
+	if( P.tok.kind != TOKEN_END )
+	{
+		node = parse_statement( &P );
+
+		if( node && P.tok.kind != TOKEN_END )
+		{
+			expr_free( node );
+			node = parse_error( &P, "Syntax Error near", &P.tok );
+		}
+	}
+
+	// Continue after the terminator, skipping the rest of a statement that failed
+	const char *p = P.tok.start;
+	while( *p && *p != ';' && *p != '\n' )
+		p++;
+	*text = *p ? p + 1 : p;
+
+	return node;
+}
+
+void expr_free( Expr_node *node )
+{
+	if( node == NULL )
+		return;
+
+	expr_free( node -> left );
+	expr_free( node -> right );
+	free_number( &node -> value );
+	free( node -> name );
+	free( node );
+}
+
+void env_free( Expr_env *env )
+{
+	for( size_t i = 0; i < env -> count; i++ )
+	{
+		free( env -> vars[i].name );
+		free_number( &env -> vars[i].value );
+	}
+
+	free( env -> vars );
+	env -> vars = NULL;
+	env -> count = env -> cap = 0;
+}
+
+/* Stores a computed value under name; the number moves out of value, which receives the variable's old limbs */
+static Status assign_variable( Expr_env *env, const char *name, Bignum *value, char sign, Expr_variable **var )
+{
+	Expr_variable *v = find_variable( env, name, strlen( name ) );
+
+	if( v == NULL )
+	{
+		if( env -> count == env -> cap )
+		{
+			size_t cap = env -> cap ? 2 * env -> cap : 8;
+			Expr_variable *vars = realloc( env -> vars, cap * sizeof( Expr_variable ) );
+			if( vars == NULL )
+			{
+				perror("INFO : Memory Allocation Failed");
+				return FAILURE;
+			}
+
+			env -> vars = vars;
+			env -> cap = cap;
+		}
+
+		v = &env -> vars[ env -> count ];
+		if( ( v -> name = copy_text( name, strlen( name ) ) ) == NULL )
+			return FAILURE;
+
+		init_number( &v -> value );
+		env -> count++;
+	}
+
+	Swap_numbers( &v -> value, value );
+	v -> sign = sign;
+	*var = v;
+
+	return SUCCESS;
+}
+
+Status expr_evaluate( const Expr_node *node, Expr_env *env, Bignum *scratch, const Bignum **value, char *sign )
+{
+	Status status = SUCCESS;
+	Expr_variable *var;
+
+	switch( node -> kind )
+	{
+		case EXPR_NUMBER:
+			*value = &node -> value;
+			*sign = node -> sign;
+			return SUCCESS;
+
+		case EXPR_VARIABLE:
+			var = find_variable( env, node -> name, strlen( node -> name ) );
+			*value = &var -> value;
+			*sign = var -> sign;
+			return SUCCESS;
+
+		case EXPR_NEGATE:
+			status = expr_evaluate( node -> left, env, scratch, value, sign );
+			*sign = ( *sign == '+' ) ? '-' : '+';
+			return status;
+
+		case EXPR_ASSIGN:
+		{
+			// The variable gets a number of its own, a copy only when the value is another name or a literal
+			Bignum own;
+			init_number( &own );
+
+			const Bignum *v;
+			char s;
+			status = expr_evaluate( node -> left, env, &own, &v, &s );
+
+			if( status == SUCCESS && v != &own )
+				status = copy_number( v, &own );
+
+			if( status == SUCCESS )
+				status = assign_variable( env, node -> name, &own, s, &var );
+
+			free_number( &own );
+
+			if( status == SUCCESS )
+			{
+				*value = &var -> value;
+				*sign = var -> sign;
+			}
+			return status;
+		}
+
+		case EXPR_BINARY:
+			break;
+	}
+
+	// "a ^ b % m" is a modular power, as on the command line
+	const Expr_node *left = node -> left,
+					*base = left,
+					*exp = node -> right,
+					*mod = NULL;
+	char op = node -> op;
+
+	if( op == '%' && left -> kind == EXPR_BINARY && left -> op == '^' )
+	{
+		base = left -> left;
+		exp = left -> right;
+		mod = node -> right;
+		op = '^';
+	}
+
+	Bignum t1, t2, t3;
+	init_number( &t1 );
+	init_number( &t2 );
+	init_number( &t3 );
+
+	const Bignum *v1, *v2, *v3 = NULL;
+	char s1, s2, s3 = '+';
+
+	status = expr_evaluate( base, env, &t1, &v1, &s1 );
+	if( status == SUCCESS )
+		status = expr_evaluate( exp, env, &t2, &v2, &s2 );
+	if( status == SUCCESS && mod )
+		status = expr_evaluate( mod, env, &t3, &v3, &s3 );
+
+	if( status == SUCCESS )
+		status = apply_operator( op, v1, s1, v2, s2, v3, s3, scratch, sign, NULL );
+
+	free_number( &t1 );
+	free_number( &t2 );
+	free_number( &t3 );
+
+	*value = scratch;
+	return status;
+}
+
+/* Parse and evaluate every statement of text, one output line per expression statement */
+static Status run_statements( const char *text, Expr_env *env, FILE *out )
+{
+	Status status = SUCCESS;
+	char error[ 96 ];
+
+	while( *text )
+	{
+		Expr_node *node = expr_parse( &text, env, error, sizeof( error ) );
+		if( node == NULL )
+		{
+			if( error[0] )
+			{
+				fprintf( out, "ERROR: %s\n", error );
+				status = FAILURE;
+			}
+			continue;
+		}
+
+		Bignum scratch;
+		init_number( &scratch );
+
+		const Bignum *value;
+		char sign;
+		Status calc = expr_evaluate( node, env, &scratch, &value, &sign );
+		char *digits = NULL;
+
+		if( calc == ZERO_DIVISOR )
+			fputs( "ERROR: Division by Zero\n", out );
+		else if( calc != SUCCESS )
+			fputs( "ERROR: Calculation Failure\n", out );
+		else if( node -> kind != EXPR_ASSIGN )
+		{
+			if( ( digits = Number_to_string( value ) ) == NULL )
+			{
+				fputs( "ERROR: Calculation Failure\n", out );
+				calc = FAILURE;
+			}
+			else
+			{
+				if( sign == '-' && value -> len )
+					fputc( '-', out );
+				fputs( digits, out );
+				fputc( '\n', out );
+			}
+		}
+
+		if( calc != SUCCESS )
+			status = FAILURE;
+
+		free( digits );
+		free_number( &scratch );
+		expr_free( node );
+	}
+
+	return status;
+}
+
+Status run_expressions( const char *program, FILE *in, FILE *out )
+{
+	apc_arena_begin();
+
+	Expr_env env = { 0 };
+	Status status = SUCCESS;
+
+	if( program )
+		status = run_statements( program, &env, out );
+	else
+	{
+		// Variables carry over from line to line
+		char *line = NULL;
+		size_t line_cap = 0;
+
+		while( getline( &line, &line_cap, in ) != -1 )
+			if( run_statements( line, &env, out ) != SUCCESS )
+				status = FAILURE;
+
+		if( ferror( in ) )
+			status = FAILURE;
+
+		free( line );
+	}
+
+	if( fflush( out ) == EOF )
+		status = FAILURE;
+
+	env_free( &env );
+	apc_arena_end();
+
+	return status;
+}
\ No newline at end of file
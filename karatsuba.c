@@ -0,0 +1,102 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : mul_karatsuba
+ * Description      : Multiplies two limb arrays with the Karatsuba divide-and-conquer algorithm. Each operand is split into a
+ *                    low and a high half at m limbs, and the product is assembled from three half-size products instead of
+ *                    four. The half-size products are computed through mul_limbs(), so they recurse into Karatsuba or fall
+ *                    back to the schoolbook kernel once they drop below karatsuba_threshold.
+ *
+ * Prototype        : Status mul_karatsuba( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+ *
+ * Input Parameters : r      -> Result array with room for an + bn limbs (must not overlap a or b).
+ *                    a, an  -> First operand limbs and limb count (an >= bn).
+ *                    b, bn  -> Second operand limbs and limb count (an < 2 × bn).
+ *
+ * Return Value     : SUCCESS -> If the product was computed.
+ *                    FAILURE -> If memory allocation fails for the temporary sums.
+ *
+ * Algorithm        :
+ *                    With a = a1·B^m + a0 and b = b1·B^m + b0 (B = 2^32, m = ceil(an / 2)):
+ *                    1. z0 = a0 × b0                 → stored directly in r[0 .. 2m).
+ *                    2. z2 = a1 × b1                 → stored directly in r[2m .. an + bn).
+ *                    3. z1 = (a0 + a1) × (b0 + b1) - z0 - z2.
+ *                    4. r += z1 · B^m.
+ *
+ * Notes            :
+ *                    • Time Complexity: O(n^1.585).
+ *                    • If b has no high half (bn <= m) the product is split by blocks of b instead.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+Status mul_karatsuba( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	STAT_SCOPE( STAT_KARATSUBA );
+
+	size_t m = ( an + 1 ) / 2;
+
+	// b too short to split at m: r = a1·b·B^m + a0·b
+	if( bn <= m )
+	{
+		limb_t *high = apc_alloc( ( an - m + bn ) * sizeof( limb_t ) );
+		if( high == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			return FAILURE;
+		}
+
+		Status status = mul_limbs( r, a, m, b, bn );
+		if( status == SUCCESS )
+			status = mul_limbs( high, a + m, an - m, b, bn );
+
+		if( status == SUCCESS )
+		{
+			memset( r + m + bn, 0, ( an - m ) * sizeof( limb_t ) );
+			add_limbs( r + m, r + m, an - m + bn, high, an - m + bn );
+		}
+
+		apc_free( high );
+		return status;
+	}
+
+	size_t hn1 = an - m,		// Limbs in a1
+		   hn2 = bn - m;		// Limbs in b1
+
+	// One block for both half sums (m + 1 limbs each) and their product (2m + 2 limbs)
+	limb_t *sa = apc_alloc( ( 4 * m + 4 ) * sizeof( limb_t ) );
+	if( sa == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+	limb_t *sb = sa + m + 1;
+	limb_t *z1 = sb + m + 1;
+
+	// z0 and z2 go straight into their final place
+	if( mul_limbs( r, a, m, b, m ) != SUCCESS || mul_limbs( r + 2 * m, a + m, hn1, b + m, hn2 ) != SUCCESS )
+	{
+		apc_free( sa );
+		return FAILURE;
+	}
+
+	// Half sums
+	sa[m] = add_limbs( sa, a, m, a + m, hn1 );
+	sb[m] = add_limbs( sb, b, m, b + m, hn2 );
+
+	if( mul_limbs( z1, sa, m + 1, sb, m + 1 ) != SUCCESS )
+	{
+		apc_free( sa );
+		return FAILURE;
+	}
+
+	// z1 = z1 - z0 - z2, never negative
+	sub_limbs( z1, z1, 2 * m + 2, r, 2 * m );
+	sub_limbs( z1, z1, 2 * m + 2, r + 2 * m, hn1 + hn2 );
+
+	// Middle term lands at offset m, its true length never runs past the product
+	size_t rn = an + bn - m;
+	size_t zn = 2 * m + 2 < rn ? 2 * m + 2 : rn;
+	add_limbs( r + m, r + m, rn, z1, zn );
+
+	apc_free( sa );
+	return SUCCESS;
+}
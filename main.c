@@ -5,13 +5,13 @@
  * Date         : 31/10/2025
  *
  * Description  : Main driver program for the Arbitrary Precision Calculator. This module validates command-line arguments,
- *                converts numeric strings into doubly linked lists, determines operation type and operand signs, and then
+ *                converts numeric strings into packed limb arrays, determines operation type and operand signs, and then
  *                calls the corresponding arithmetic function. The program supports addition, subtraction, multiplication,
  *                division, modulus, and power for numbers of arbitrary length.
  *
- *                Each number is represented as a doubly linked list where:
- *                - The head node stores the Most Significant Digit (MSD)
- *                - The tail node stores the Least Significant Digit (LSD)
+ *                Each number is represented as a Bignum (contiguous base 2^32 limb array) where:
+ *                - limbs[0] stores the Least Significant Limb
+ *                - limbs[len - 1] stores the Most Significant Limb
  *
  *                The program performs sign management, magnitude comparison, and formatted result display for all operations.
  *                Arithmetic operations are implemented in modular source files with clear separation of concerns.
@@ -23,17 +23,22 @@
  *                /  → Division (Quotient)
  *                %  → Modulus (Remainder)
  *                ^  → Power (Exponentiation)
+ *                ^ % → Modular Power (base ^ exponent % modulus, never builds the full power)
  *
  * Features:
  *                • Handles arbitrarily large integers beyond built-in data type limits.
  *                • Maintains correct sign and magnitude for all operations.
  *                • Detects and handles divide-by-zero safely.
  *                • Supports zero and negative exponents (integer logic: negative powers → 0).
- *                • Provides formatted, right-aligned output for clarity.
- *                • Demonstrates modular, structured, and memory-safe design using doubly linked lists.
+ *                • Provides formatted, right-aligned output for clarity, or raw digits written in large blocks (--raw).
+ *                • Server mode answers batch lines over a Unix domain socket without a process per calculation.
+ *                • Expression mode evaluates whole formulas in-process, keeping intermediates and variables as numbers.
+ *                • Batch mode streams newline-delimited calculations over a work-stealing thread pool and prints one
+ *                  result per line, in input order.
+ *                • Demonstrates modular, structured, and memory-safe design using packed limb arrays.
  *
  * Key Concepts Demonstrated:
- *                - Dynamic memory allocation and linked list manipulation.
+ *                - Dynamic memory allocation and limb array manipulation.
  *                - Modular arithmetic algorithm implementation.
  *                - Robust sign handling and operand normalization.
  *                - Command-line parsing and input validation.
@@ -42,6 +47,26 @@
  * Usage Example:
  *                ./apc.out <number1> <operator> <number2>
  *                Example → ./apc.out -1234 x +56
+ *                ./apc.out <base> ^ <exponent> % <modulus>
+ *                Example → ./apc.out 7 ^ 1000000 % 1000000007
+ *                ./apc.out -j 8 <number1> x <number2>     (threads for one large multiplication, default all cores)
+ *                ./apc.out --raw 3 ^ 100000000            (plain signed result and a newline, no layout; for huge results)
+ *                ./apc.out --raw @a.txt x @b.txt          (operands memory-mapped from files holding decimal text)
+ *                ./apc.out --batch [-j threads] [file]   (one calculation per line, stdin when no file or "-",
+ *                                                          all online cores unless -j is given)
+ *                ./apc_stats.out --stats 3 ^ 100000      (instrumented build from "make stats": call counts, times and
+ *                                                          memory of every operation as JSON on stderr)
+ *                Example → printf '12 + 30\n-7 x 6\n' | ./apc.out --batch
+ *                ./apc.out --expr '<statements>'          (expressions with precedence, parentheses and variables; statements
+ *                                                          separated by ';' or new lines, read from stdin when none or "-")
+ *                Example → ./apc.out --expr 'a = 2 ^ 127 - 1; (a + 1) x 3 ^ 5 % a'
+ *                ./apc.out --plan '<expression>' [file]  (expression compiled once, then evaluated for each line of input
+ *                                                          values, one per variable in order of first appearance)
+ *                Example → printf '7 3\n100 9\n' | ./apc.out --plan '(a / b) x b + a % b'
+ *                ./apc.out --serve /tmp/apc.sock [-j n]  (long-lived server: batch lines over a Unix domain socket,
+ *                                                          n connections at a time, stopped by SIGINT / SIGTERM)
+ *                ./apc.out --batch --cache 256 [file]     (result cache of 256 MiB for repeated products, divisions and
+ *                                                          powers; also for --serve; hit and miss counts on stderr at exit)
  *
  * Output Format:
  *                    -1234
@@ -51,192 +76,303 @@
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
+#include <errno.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
-int main( int argc, char* argv[] )
+#ifdef APC_STATS
+/* atexit() handler for --stats: every exit path, error or not, reports what was run */
+static void print_stats( void )
 {
-	/* Validate CLArguments */
-	if( Validate_arguments( argc, argv ) == FAILURE )
-	{
-		printf("INFO : Invalid Arguments! Please provide Two Numbers and One Operator.\n");
-		printf("Format : ./a.out <number1> <operator> <number2>\n");
-		exit(1);
-	}
+	stats_dump( stderr );
+}
+#endif
 
-	/* Declare the pointers */
-	Dlist *head1 = NULL, 
-		  *tail1 = NULL,
-		  *head2 = NULL,
-		  *tail2 = NULL,
-		  *headR = NULL,
-		  *tailR = NULL;
-	char operator;
+/* --stats needs the instrumented build, the normal one compiles the counters out */
+static void enable_stats( void )
+{
+#ifdef APC_STATS
+	atexit( print_stats );
+#else
+	printf("INFO : Statistics are not compiled in, build apc_stats.out with \"make stats\"\n");
+	exit(1);
+#endif
+}
+
+/* atexit() handler for --cache: hit and miss counters of the result cache */
+static void print_cache( void )
+{
+	cache_report( stderr );
+}
 
-	/* Convert both Numbers to LLs */
-	String_to_list( &head1, &tail1, argv[1] );
-	String_to_list( &head2, &tail2, argv[3] );
-	operator = argv[2][0];
+/* --cache <MiB>: turns on the result cache with that memory budget; a missing, bad or repeated value prints usage */
+static void enable_cache( const char *mib, const char *usage )
+{
+	static int enabled;
+	unsigned long long budget = 0;
 
-	char sign1 = '+', sign2 = '+';
-	if( argv[1][0] == '+' ) sign1 = '+';
-	if( argv[1][0] == '-' ) sign1 = '-';
+	if( mib && isNumeric( mib ) == NUMERIC && mib[0] != '-' )
+	{
+		char *end;
+		errno = 0;
+		budget = strtoull( mib, &end, 10 );
+		if( errno || *end )
+			budget = 0;
+	}
 
-	if( argv[3][0] == '+' ) sign2 = '+';
-	if( argv[3][0] == '-' ) sign2 = '-';
+	// The budget is given in MiB, so it must still fit a size_t once shifted to bytes
+	if( enabled || budget == 0 || budget > ( SIZE_MAX >> 20 ) )
+	{
+		printf( "%s", usage );
+		exit(1);
+	}
 
-	char final_sign;
+	if( cache_enable( (size_t) budget << 20 ) != SUCCESS )
+		exit(1);
 
-	switch ( operator )
-	{
-		case '+':
-			/* call the function to perform the addition operation */
+	enabled = 1;
+	atexit( print_cache );
+}
 
-			if( sign1 ==  sign2 )
+int main( int argc, char* argv[] )
+{
+	/* Batch mode: one calculation per line from a file or stdin, over all cores unless -j says otherwise */
+	if( argc >= 2 && ( strcmp( argv[1], "-b" ) == 0 || strcmp( argv[1], "--batch" ) == 0 ) )
+	{
+		// Results go out in 64 KiB blocks; setvbuf() has to run before anything is written to stdout
+		static char out_buffer[ 1 << 16 ];
+		setvbuf( stdout, out_buffer, _IOFBF, sizeof( out_buffer ) );
+
+		const char *usage = "Format : ./a.out --batch [-j threads] [--stats] [--cache MiB] [file]\n";
+		long threads = sysconf( _SC_NPROCESSORS_ONLN );
+		char *file = NULL;
+
+		for( int i = 2; i < argc; i++ )
+		{
+			if( ( strcmp( argv[i], "-j" ) == 0 || strcmp( argv[i], "--threads" ) == 0 ) && i + 1 < argc
+				&& isNumeric( argv[i + 1] ) == NUMERIC && argv[i + 1][0] != '-' && atol( argv[i + 1] ) > 0 )
+				threads = atol( argv[++i] );
+			else if( strcmp( argv[i], "--stats" ) == 0 )
+				enable_stats();
+			else if( strcmp( argv[i], "--cache" ) == 0 )
+				enable_cache( i + 1 < argc ? argv[++i] : NULL, usage );
+			else if( file == NULL )
+				file = argv[i];
+			else
 			{
-				addition( &head1, &tail1, &head2, &tail2, &headR, &tailR );
-				final_sign = sign1;
+				printf( "%s", usage );
+				exit(1);
 			}
+		}
 
-			else if( sign1 == '-' )
-			{
-				// (-a) + (b)
-
-				Status larger = Find_largest( head1, head2 );
-				if( larger == LARGE_2 )
-				{
-					Swap_lists( &head1, &tail1, &head2, &tail2 );
-					final_sign = '+';  // b is larger means, result positive
-				}
-				else
-				{
-					final_sign = '-'; // a is larger means, result negative
-				}
-
-				subtraction( &head1, &tail1, &head2, &tail2, &headR, &tailR );
-			}
+		FILE *in = stdin;
+		if( file && strcmp( file, "-" ) != 0 && ( in = fopen( file, "r" ) ) == NULL )
+		{
+			perror("INFO : Cannot open batch file");
+			exit(1);
+		}
 
-			else if( sign2 == '-' )
-			{
-				// (a) + (-b)
-
-				Status larger = Find_largest( head1, head2 );
-				if( larger == LARGE_2 )
-				{
-					Swap_lists( &head1, &tail1, &head2, &tail2 );
-					final_sign = '-'; // b is larger means, result negative
-				}
-				else
-				{
-					final_sign = '+'; // a is larger means, result positive
-				}
-
-				subtraction( &head1, &tail1, &head2, &tail2, &headR, &tailR );
-			}
-			
-			break;
+		Status status = run_batch_parallel( in, stdout, threads > 0 ? (int) threads : 1 );
 
-		case '-':	
-			/* call the function to perform the subtraction operation */
+		if( in != stdin )
+			fclose( in );
+
+		return status == SUCCESS ? 0 : 1;
+	}
 
-			if( sign1 != sign2 )
+	/* Server mode: batch lines over a Unix domain socket, one connection per pool worker, until SIGINT / SIGTERM */
+	if( argc >= 3 && ( strcmp( argv[1], "-s" ) == 0 || strcmp( argv[1], "--serve" ) == 0 ) )
+	{
+		const char *usage = "Format : ./a.out --serve <socket path> [-j threads] [--stats] [--cache MiB]\n";
+		long threads = sysconf( _SC_NPROCESSORS_ONLN );
+
+		for( int i = 3; i < argc; i++ )
+		{
+			if( ( strcmp( argv[i], "-j" ) == 0 || strcmp( argv[i], "--threads" ) == 0 ) && i + 1 < argc
+				&& isNumeric( argv[i + 1] ) == NUMERIC && argv[i + 1][0] != '-' && atol( argv[i + 1] ) > 0 )
+				threads = atol( argv[++i] );
+			else if( strcmp( argv[i], "--stats" ) == 0 )
+				enable_stats();
+			else if( strcmp( argv[i], "--cache" ) == 0 )
+				enable_cache( i + 1 < argc ? argv[++i] : NULL, usage );
+			else
 			{
-				addition( &head1, &tail1, &head2, &tail2, &headR, &tailR );
-				final_sign = sign1;
+				printf( "%s", usage );
+				exit(1);
 			}
+		}
 
-			else 
-			{
-				// Same sign: do maginitude based subtraction
-				Status larger = Find_largest( head1, head2 );
-				if( larger == LARGE_2 )
-				{
-					Swap_lists( &head1, &tail1, &head2, &tail2 );
-					final_sign = ( sign1 == '+' ) ? '-': '+'; // Result sign is opposite
-				}
-				else
-				{
-					final_sign = sign1; // Result sign is same as bigger number
-				}
-
-				subtraction( &head1, &tail1, &head2, &tail2, &headR, &tailR );
+		return run_server( argv[2], threads > 0 ? (int) threads : 1 ) == SUCCESS ? 0 : 1;
+	}
 
+	/* Expression mode: statements with precedence, parentheses and variables, from the argument or line by line from stdin */
+	if( argc >= 2 && ( strcmp( argv[1], "-e" ) == 0 || strcmp( argv[1], "--expr" ) == 0 ) )
+	{
+		char *program = NULL;
+
+		for( int i = 2; i < argc; i++ )
+		{
+			if( ( strcmp( argv[i], "-j" ) == 0 || strcmp( argv[i], "--threads" ) == 0 ) && i + 1 < argc
+				&& isNumeric( argv[i + 1] ) == NUMERIC && argv[i + 1][0] != '-' && atol( argv[i + 1] ) > 0 )
+				mul_threads = (size_t) atol( argv[++i] );
+			else if( strcmp( argv[i], "--stats" ) == 0 )
+				enable_stats();
+			else if( program == NULL )
+				program = argv[i];
+			else
+			{
+				printf("Format : ./a.out --expr [-j threads] [--stats] ['statements' | -]\n");
+				exit(1);
 			}
+		}
 
-			break;
-
-		case 'x':	
-			/* call the function to perform the multiplication operation */
+		if( program && strcmp( program, "-" ) == 0 )
+			program = NULL;
 
-			multiplication( &head1, &tail1,&head2, &tail2, &headR, &tailR );
+		return run_expressions( program, stdin, stdout ) == SUCCESS ? 0 : 1;
+	}
 
-			if( sign1 == sign2 )
-				final_sign = '+';
+	/* Plan mode: one expression compiled once, then evaluated for every line of input values */
+	if( argc >= 3 && ( strcmp( argv[1], "-p" ) == 0 || strcmp( argv[1], "--plan" ) == 0 ) )
+	{
+		char *file = NULL;
+
+		for( int i = 3; i < argc; i++ )
+		{
+			if( ( strcmp( argv[i], "-j" ) == 0 || strcmp( argv[i], "--threads" ) == 0 ) && i + 1 < argc
+				&& isNumeric( argv[i + 1] ) == NUMERIC && argv[i + 1][0] != '-' && atol( argv[i + 1] ) > 0 )
+				mul_threads = (size_t) atol( argv[++i] );
+			else if( strcmp( argv[i], "--stats" ) == 0 )
+				enable_stats();
+			else if( file == NULL )
+				file = argv[i];
 			else
-				final_sign = '-';
-
-			break;
+			{
+				printf("Format : ./a.out --plan 'expression' [-j threads] [--stats] [file]\n");
+				exit(1);
+			}
+		}
 
-		case '/':	
-			/* call the function to perform the division operation */
+		FILE *in = stdin;
+		if( file && strcmp( file, "-" ) != 0 && ( in = fopen( file, "r" ) ) == NULL )
+		{
+			perror("INFO : Cannot open input file");
+			exit(1);
+		}
 
-			division( &head1, &tail1,&head2, &tail2, &headR, &tailR, "Div" );
+		Status status = run_plan( argv[2], in, stdout );
 
-			if( sign1 == sign2 )
-				final_sign = '+';
-			else
-				final_sign = '-';
+		if( in != stdin )
+			fclose( in );
 
-			break;
+		return status == SUCCESS ? 0 : 1;
+	}
 
-		case '%':	
-			/* call the function to perform the division operation */
+	/* Optional leading "-j threads" (threads used by one large multiplication), "--raw" (plain result only) and
+	   "--stats" (operation counts, timings and memory as JSON on stderr) */
+	int raw = 0;
 
-			division( &head1, &tail1,&head2, &tail2, &headR, &tailR, "Mod" );
+	while( argc >= 2 )
+	{
+		if( strcmp( argv[1], "-r" ) == 0 || strcmp( argv[1], "--raw" ) == 0 )
+		{
+			raw = 1;
+
+			argv[1] = argv[0];
+			argv += 1;
+			argc -= 1;
+		}
+		else if( strcmp( argv[1], "--stats" ) == 0 )
+		{
+			enable_stats();
+
+			argv[1] = argv[0];
+			argv += 1;
+			argc -= 1;
+		}
+		else if( argc >= 3 && ( strcmp( argv[1], "-j" ) == 0 || strcmp( argv[1], "--threads" ) == 0 ) )
+		{
+			if( isNumeric( argv[2] ) == NON_NUMERIC || argv[2][0] == '-' || atol( argv[2] ) <= 0 )
+			{
+				printf("INFO : Invalid Thread Count\n");
+				exit(1);
+			}
 
-			if( sign1 == sign2 )
-				final_sign = '+';
-			else
-				final_sign = '-';
+			mul_threads = (size_t) atol( argv[2] );
 
+			// Drop the option so the calculation sits at argv[1..]
+			argv[2] = argv[0];
+			argv += 2;
+			argc -= 2;
+		}
+		else
 			break;
+	}
 
-		case '^': 
-			/// Check for negative exponent (if sign2 == '-')
-			if( sign2 == '-' )
-			{
-				// Result of any base^(-exp) = 0 (integer APC logic)
-				headR = tailR = NULL;
-				insert_at_first( &headR, &tailR, 0 );
-				final_sign = '+';
-				break;
-			}
+	/* Validate CLArguments */
+	if( Validate_arguments( argc, argv ) == FAILURE )
+	{
+		printf("INFO : Invalid Arguments! Please provide Two Numbers and One Operator.\n");
+		printf("Format : ./a.out [-j threads] [--raw] [--stats] <number1> <operator> <number2>   (a number may be @file)\n");
+		printf("         ./a.out <base> ^ <exponent> %% <modulus>\n");
+		printf("         ./a.out --batch [-j threads] [--stats] [--cache MiB] [file]\n");
+		printf("         ./a.out --expr [-j threads] [--stats] ['statements' | -]\n");
+		printf("         ./a.out --plan 'expression' [-j threads] [--stats] [file]\n");
+		printf("         ./a.out --serve <socket path> [-j threads] [--stats] [--cache MiB]\n");
+		exit(1);
+	}
 
-			// Determine sign of result
-			if( sign1 == '+' )
-				final_sign = '+';
+	/* Every buffer of this evaluation comes from one arena, released in bulk at the end */
+	apc_arena_begin();
 
-			else
-			{
-				// sign1 is '-', exponent positive → depends on even/odd
-				if( is_exp_even( head2 ) == EVEN )
-					final_sign = '+';
+	/* Declare the numbers */
+	Bignum num1, num2, num3, result;
+	init_number( &num1 );
+	init_number( &num2 );
+	init_number( &num3 );
+	init_number( &result );
 
-				else
-					final_sign = '-';
-			}
+	char final_sign;
 
-			// Perform power normally, exponent is positive
-			power( &head1, &tail1, &head2, &tail2, &headR, &tailR );
+	/* Sign handling and the operation itself live in calculate() */
+	Status status = calculate( argc, argv, &num1, &num2, &num3, &result, &final_sign, NULL );
 
-			break;
+	if( status == ZERO_DIVISOR )
+	{
+		printf("INFO: Division by Zero is not possible\n");
+		exit(0);
+	}
 
-		default:
-			printf("INFO : Invalid Input:-( Try again...)\n");
-			return FAILURE;
+	if( status == NON_NUMERIC )
+	{
+		printf("INFO : Operand File does not hold a Number\n");
+		exit(1);
 	}
 
-	
-	print_calculation( argv[1], operator, argv[3], headR, &final_sign );
+	if( status != SUCCESS )
+	{
+		printf("INFO : Calculation Failure\n");
+		exit(1);
+	}
+
+	if( raw )
+	{
+		// Large results: one buffered write() path instead of the aligned layout
+		if( print_raw( STDOUT_FILENO, &result, final_sign ) != SUCCESS )
+		{
+			perror("INFO : Cannot write result");
+			exit(1);
+		}
+	}
+	else
+		print_calculation( argv[1], argv[2][0], argv[3], ( argc == 6 ) ? argv[5] : NULL, &result, &final_sign );
+
+	free_number( &num1 );
+	free_number( &num2 );
+	free_number( &num3 );
+	free_number( &result );
+	apc_arena_end();
 	return 0;
 }
\ No newline at end of file
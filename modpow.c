@@ -0,0 +1,237 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : mod_power
+ * Description      : Computes modular exponentiation (base^exponent mod modulus) without ever building the full power. The
+ *                    sliding-window scan of power() (window_power) is reused, but every product is reduced modulo the modulus
+ *                    straight away, so all intermediates stay at the size of the modulus. Two reductions are used:
+ *                      - Montgomery multiplication (CIOS form) for odd moduli below montgomery_threshold limbs.
+ *                      - Barrett reduction with a precomputed floor(B^(2n) / m) for all other moduli.
+ *
+ * Prototype        : Status mod_power( const Bignum *base, const Bignum *exp, const Bignum *mod, Bignum *result );
+ *
+ * Input Parameters : base   -> Base number.
+ *                    exp    -> Exponent number.
+ *                    mod    -> Modulus number.
+ *                    result -> Number receiving base^exp mod modulus (must not alias the inputs).
+ *
+ * Return Value     : SUCCESS      -> If the computation completes successfully.
+ *                    ZERO_DIVISOR -> Modulus is zero, result is untouched.
+ *                    FAILURE      -> If limb allocation fails.
+ *
+ * Special Cases    :
+ *                    • Modulus = 0 → Returns ZERO_DIVISOR (same as division by zero).
+ *                    • Modulus = 1 → Result = 0.
+ *                    • Exponent = 0 → Result = 1.
+ *
+ * Algorithm        :
+ *                    1. Reduce the base modulo the modulus.
+ *                    2. Montgomery (odd modulus, n < montgomery_threshold limbs):
+ *                         a. m' = -m^-1 mod 2^32 by Newton iteration.
+ *                         b. Map the base into Montgomery form b·R mod m, with R = B^n.
+ *                         c. window_power() with mont_multiply(): a·b·R^-1 mod m, interleaving the limb products
+ *                            with the reduction so the accumulator never exceeds n + 2 limbs.
+ *                         d. One more mont_multiply() by 1 maps the result back.
+ *                    3. Barrett (any modulus):
+ *                         a. mu = floor(B^(2n) / m).
+ *                         b. window_power() with barrett_multiply(): x = a·b, q = ((x / B^(n-1)) · mu) / B^(n+1),
+ *                            r = x - q·m, then at most two subtractions of m.
+ *
+ * Notes            :
+ *                    • Works purely on magnitudes; sign and display are handled externally by the main driver.
+ *                    • Barrett's products go through multiplication(), so large moduli benefit from Karatsuba / Toom-3 / NTT.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+size_t montgomery_threshold = MONTGOMERY_THRESHOLD;
+
+typedef struct
+{
+	const Bignum *mod;		// Modulus m
+	size_t n;				// Limbs in m
+	limb_t minv;			// -m^-1 mod 2^32, Montgomery only
+	limb_t *scratch;		// Montgomery: padded operands and the n + 2 limb accumulator
+	Bignum mu;				// floor(B^(2n) / m), Barrett only
+	Bignum prod, t1, t2;	// Barrett temporaries
+} Mod_ctx;
+
+/* Montgomery product: result = num1 · num2 · B^-n mod m for num1, num2 < m */
+static Status mont_multiply( const Bignum *num1, const Bignum *num2, Bignum *result, void *arg )
+{
+	Mod_ctx *ctx = arg;
+	size_t n = ctx -> n;
+	const limb_t *m = ctx -> mod -> limbs;
+	limb_t *a = ctx -> scratch,
+		   *b = a + n,
+		   *t = b + n;
+
+	// Operands padded to exactly n limbs
+	memset( ctx -> scratch, 0, ( 3 * n + 2 ) * sizeof( limb_t ) );
+	if( num1 -> len ) memcpy( a, num1 -> limbs, num1 -> len * sizeof( limb_t ) );
+	if( num2 -> len ) memcpy( b, num2 -> limbs, num2 -> len * sizeof( limb_t ) );
+
+	for( size_t i = 0; i < n; i++ )
+	{
+		// t += a · b[i]
+		limb_t carry = 0;
+		for( size_t j = 0; j < n; j++ )
+		{
+			dlimb_t s = (dlimb_t) a[j] * b[i] + t[j] + carry;
+			t[j] = (limb_t) s;
+			carry = (limb_t) ( s >> LIMB_BITS );
+		}
+		dlimb_t s = (dlimb_t) t[n] + carry;
+		t[n] = (limb_t) s;
+		t[n + 1] = (limb_t) ( s >> LIMB_BITS );
+
+		// t = ( t + q · m ) / B, q chosen so the low limb cancels
+		limb_t q = t[0] * ctx -> minv;
+		s = (dlimb_t) q * m[0] + t[0];
+		carry = (limb_t) ( s >> LIMB_BITS );
+		for( size_t j = 1; j < n; j++ )
+		{
+			s = (dlimb_t) q * m[j] + t[j] + carry;
+			t[j - 1] = (limb_t) s;
+			carry = (limb_t) ( s >> LIMB_BITS );
+		}
+		s = (dlimb_t) t[n] + carry;
+		t[n - 1] = (limb_t) s;
+		t[n] = t[n + 1] + (limb_t) ( s >> LIMB_BITS );
+	}
+
+	// Final conditional subtraction brings t below m
+	if( t[n] || compare_limbs( t, m, n ) != LARGE_2 )
+		sub_limbs( t, t, n, m, n );
+
+	if( reserve_number( result, n ) != SUCCESS )
+		return FAILURE;
+
+	memcpy( result -> limbs, t, n * sizeof( limb_t ) );
+	result -> len = n;
+	trim_number( result );
+
+	return SUCCESS;
+}
+
+/* Barrett product: result = num1 · num2 mod m for num1, num2 < m */
+static Status barrett_multiply( const Bignum *num1, const Bignum *num2, Bignum *result, void *arg )
+{
+	Mod_ctx *ctx = arg;
+	size_t n = ctx -> n;
+	Bignum *x = &ctx -> prod;
+
+	if( multiplication( num1, num2, x ) != SUCCESS )
+		return FAILURE;
+
+	// q = floor( floor( x / B^(n-1) ) · mu / B^(n+1) ), at most 2 below the true quotient
+	if( x -> len > n - 1 )
+	{
+		Bignum top = { x -> limbs + n - 1, x -> len - ( n - 1 ), x -> len - ( n - 1 ) };
+
+		if( multiplication( &top, &ctx -> mu, &ctx -> t1 ) != SUCCESS )
+			return FAILURE;
+		shift_number_down( &ctx -> t1, n + 1 );
+	}
+	else
+		ctx -> t1.len = 0;
+
+	// r = x - q · m
+	if( multiplication( &ctx -> t1, ctx -> mod, &ctx -> t2 ) != SUCCESS || subtraction( x, &ctx -> t2, result ) != SUCCESS )
+		return FAILURE;
+
+	while( Find_largest( result, ctx -> mod ) != LARGE_2 )
+	{
+		if( sub_from( result, ctx -> mod ) != SUCCESS )
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+Status mod_power( const Bignum *base, const Bignum *exp, const Bignum *mod, Bignum *result )
+{
+	STAT_SCOPE( STAT_MOD_POWER );
+
+	// Modulus zero is reported to the caller, never computed
+	if( mod -> len == 0 )
+		return ZERO_DIVISOR;
+
+	// Modulus one: every residue is zero
+	if( mod -> len == 1 && mod -> limbs[0] == 1 )
+	{
+		result -> len = 0;
+		return SUCCESS;
+	}
+
+	// Case: Exponent is zero
+	if( exp -> len == 0 )
+		return set_number_word( result, 1 );
+
+	Mod_ctx ctx;
+	ctx.mod = mod;
+	ctx.n = mod -> len;
+	ctx.scratch = NULL;
+	init_number( &ctx.mu );
+	init_number( &ctx.prod );
+	init_number( &ctx.t1 );
+	init_number( &ctx.t2 );
+
+	Bignum b, temp;
+	init_number( &b );
+	init_number( &temp );
+
+	// 1. b = base mod m
+	Status status = divide_numbers( base, mod, &temp, &b );
+
+	if( status == SUCCESS && b.len == 0 )
+		result -> len = 0;
+
+	// 2. Montgomery for odd moduli
+	else if( status == SUCCESS && ( mod -> limbs[0] & 1 ) && ctx.n < montgomery_threshold )
+	{
+		size_t n = ctx.n;
+
+		// Newton iteration doubles the correct low bits of m^-1 every round
+		limb_t inv = mod -> limbs[0];
+		for( int i = 0; i < 5; i++ )
+			inv *= 2 - mod -> limbs[0] * inv;
+		ctx.minv = -inv;
+
+		ctx.scratch = apc_alloc( ( 3 * n + 2 ) * sizeof( limb_t ) );
+		if( ctx.scratch == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			status = FAILURE;
+		}
+
+		// b · R mod m
+		if( status == SUCCESS && ( status = shift_number_up( &b, n ) ) == SUCCESS )
+			status = divide_numbers( &b, mod, &temp, &ctx.prod );
+
+		if( status == SUCCESS )
+			status = window_power( &ctx.prod, exp, &temp, mont_multiply, &ctx );
+
+		// Leave Montgomery form: multiply by plain 1
+		if( status == SUCCESS && ( status = set_number_word( &b, 1 ) ) == SUCCESS )
+			status = mont_multiply( &temp, &b, result, &ctx );
+	}
+
+	// 3. Barrett for everything else
+	else if( status == SUCCESS )
+	{
+		if( ( status = set_base_power( &temp, 2 * ctx.n ) ) == SUCCESS )
+			status = divide_numbers( &temp, mod, &ctx.mu, &ctx.t1 );
+
+		if( status == SUCCESS )
+			status = window_power( &b, exp, result, barrett_multiply, &ctx );
+	}
+
+	apc_free( ctx.scratch );
+	free_number( &ctx.mu );
+	free_number( &ctx.prod );
+	free_number( &ctx.t1 );
+	free_number( &ctx.t2 );
+	free_number( &b );
+	free_number( &temp );
+
+	return status;
+}
\ No newline at end of file
@@ -1,93 +1,333 @@
 /*******************************************************************************************************************************************************************
  * Function Name    : multiplication
- * Description      : Performs multiplication of two large positive numbers represented as doubly linked lists. Each node stores
- *                    a single digit, where the head represents the Most Significant Digit (MSD) and the tail represents the Least
- *                    Significant Digit (LSD). The function implements the classical digit-by-digit multiplication algorithm
- *                    (similar to manual long multiplication), where each digit of one number is multiplied with every digit of
- *                    the other number. Partial results are accumulated directly in the result list with proper carry propagation.
+ * Description      : Performs multiplication of two large positive numbers represented as packed limb arrays. Each limb stores
+ *                    a base 2^32 digit, with index 0 holding the Least Significant Limb. The product is computed by mul_limbs(),
+ *                    which picks an algorithm from the operand sizes: the classical limb-by-limb schoolbook kernel (similar to
+ *                    manual long multiplication) for small operands, Karatsuba (karatsuba.c), Toom-3 (toom3.c) and the
+ *                    three-prime NTT (ntt.c) above their crossover thresholds, and block splitting for very unbalanced operands.
  *
- * Prototype        : Status multiplication( Dlist **head1, Dlist **tail1,
- *                                           Dlist **head2, Dlist **tail2,
- *                                           Dlist **headR, Dlist **tailR );
+ * Prototype        : Status multiplication( const Bignum *num1, const Bignum *num2, Bignum *result );
+ *                    Status mul_small( Bignum *num, limb_t w );
+ *                    Status mul_add( Bignum *acc, const Bignum *b, const Bignum *c );
  *
- * Input Parameters : head1, tail1 -> Pointers to the head and tail of the first number list.
- *                    head2, tail2 -> Pointers to the head and tail of the second number list.
- *                    headR, tailR -> Pointers to the head and tail of the result number list (initially empty).
+ * Input Parameters : num1   -> First number.
+ *                    num2   -> Second number.
+ *                    result -> Number receiving the product (must not alias num1 or num2).
+ *                    num, w -> mul_small(): number multiplied in place by the machine word w.
+ *                    acc    -> mul_add(): accumulator updated in place, acc += b × c (must not alias b or c).
  *
  * Return Value     : SUCCESS -> If multiplication completes successfully.
- *                    FAILURE -> If memory allocation fails during node creation.
+ *                    FAILURE -> If memory allocation fails while growing the result.
  *
  * Special Cases    :
  *                    • If either operand is zero → Result = 0.
  *                    • Sign handling is not performed here; it is managed externally by the main driver.
  *
- * Algorithm        :
- *                    1. Determine the lengths of both operand lists (len1 and len2).
- *                    2. Initialize the result list with (len1 + len2) zeros — the maximum possible number of digits.
- *                    3. Starting from the LSD of the second number:
- *                         a. Multiply the current digit of the second number with all digits of the first number (LSD → MSD).
- *                         b. Add product + existing result digit + carry.
- *                         c. Update result digit as (product % 10) and propagate carry.
- *                    4. After processing one digit of the second number, shift the result starting position left by one node.
- *                    5. Remove any leading zeros from the final result.
+ * Algorithm (mul_limbs dispatch, len1 >= len2):
+ *                    • len2 <  karatsuba_threshold            → mul_basecase().
+ *                    • len2 >= ntt_threshold                  → mul_ntt() (ntt.c), while len1 + len2 <= NTT_MAX_LENGTH.
+ *                    • len1 >= 2 × len2                       → mul_unbalanced(): split num1 into len2-limb blocks.
+ *                    • len2 <  toom3_threshold                → mul_karatsuba().
+ *                    • otherwise                              → mul_toom3().
+ *
+ * Algorithm (mul_basecase):
+ *                    1. Take the limb counts of both operands (len1 and len2).
+ *                    2. Initialize the result with (len1 + len2) zero limbs — the maximum possible number of limbs.
+ *                    3. Starting from the least significant limb of the second number:
+ *                         a. Multiply the current limb of the second number with all limbs of the first number.
+ *                         b. Add product + existing result limb + carry in double-width arithmetic.
+ *                         c. Update result limb as the low half and propagate the high half as carry.
+ *                    4. After processing one limb of the second number, shift the result starting position up by one limb.
+ *                    5. Remove any leading zero limbs from the final result.
  *
  * Notes            :
- *                    • Performs in-place accumulation, avoiding creation of temporary intermediate lists.
- *                    • Time Complexity: O(n × m), where n and m are the lengths of the two input numbers.
+ *                    • The schoolbook kernel performs in-place accumulation, avoiding temporary intermediate numbers; its
+ *                      rows are the mul_word() / addmul_word() kernels, which mul_small() and mul_add() use directly.
+ *                    • A one-limb operand is a single mul_word() row, i.e. an O(n) pass. mul_word() and addmul_word()
+ *                      multiply two limbs as one 64-bit word per step where the compiler has 128-bit integers and the
+ *                      host is little-endian (LIMB_PAIR_WORDS), and one limb per step otherwise.
+ *                    • mul_add() with a factor below karatsuba_threshold limbs adds its rows straight into the
+ *                      accumulator; longer factors go through one arena scratch product from mul_limbs().
+ *                    • Time Complexity: O(n × m) for schoolbook, O(n^1.585) for Karatsuba, O(n^1.465) for Toom-3 and
+ *                      O(n log n) for the NTT.
+ *                    • Thresholds are in limbs; they default to KARATSUBA_THRESHOLD / TOOM3_THRESHOLD / NTT_THRESHOLD from
+ *                      apc.h and can be overridden at build time (-D) or changed at run time through the matching variables.
  *                    • This function operates purely on magnitudes; external logic handles sign and display formatting.
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
 
-Status multiplication( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR )
+size_t karatsuba_threshold = KARATSUBA_THRESHOLD;
+size_t toom3_threshold = TOOM3_THRESHOLD;
+size_t ntt_threshold = NTT_THRESHOLD;
+
+static Status mul_unbalanced( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+
+Status multiplication( const Bignum *num1, const Bignum *num2, Bignum *result )
+{
+	STAT_SCOPE( STAT_MULTIPLICATION );
+
+	// Either operand zero gives zero
+	if( num1 -> len == 0 || num2 -> len == 0 )
+	{
+		result -> len = 0;
+		return SUCCESS;
+	}
+
+	// Maximum possible limbs will be sum of both lengths
+	if( reserve_number( result, num1 -> len + num2 -> len ) != SUCCESS )
+		return FAILURE;
+
+	if( mul_limbs( result -> limbs, num1 -> limbs, num1 -> len, num2 -> limbs, num2 -> len ) != SUCCESS )
+		return FAILURE;
+
+	result -> len = num1 -> len + num2 -> len;
+
+	// Remove leading zeroes from result
+	trim_number( result );
+		
+	return SUCCESS;
+}
+
+/* Size based algorithm selection: r[0..an+bn) = a × b. r must not overlap a or b. */
+Status mul_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	// Let a be the longer operand
+	if( an < bn )
+	{
+		const limb_t *t = a; a = b; b = t;
+		size_t tn = an; an = bn; bn = tn;
+	}
+
+	// Below four limbs the half sums are as long as the operands, so recursion would not shrink
+	if( bn < karatsuba_threshold || bn < 4 )
+	{
+		mul_basecase( r, a, an, b, bn );
+		return SUCCESS;
+	}
+
+	// Transform length follows an + bn, so unbalanced operands need no splitting here
+	if( bn >= ntt_threshold && an + bn <= NTT_MAX_LENGTH )
+		return mul_ntt( r, a, an, b, bn );
+
+	if( an >= 2 * bn )
+		return mul_unbalanced( r, a, an, b, bn );
+
+	if( bn < toom3_threshold )
+		return mul_karatsuba( r, a, an, b, bn );
+
+	return mul_toom3( r, a, an, b, bn );
+}
+
+/* Schoolbook kernel: r[0..an+bn) = a × b */
+void mul_basecase( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	STAT_SCOPE( STAT_MUL_BASECASE );
+
+	if( bn == 0 )
+	{
+		memset( r, 0, an * sizeof( limb_t ) );
+		return;
+	}
+
+	// First row writes the result, later rows accumulate into it shifted up by one limb each
+	r[an] = mul_word( r, a, an, b[0] );
+
+	for( size_t j = 1; j < bn; j++ )
+		r[j + an] = addmul_word( r + j, a, an, b[j] );
+}
+
+/* Limb kernel: r[0..n) = a × w, returns the carry limb. r may alias a. */
+limb_t mul_word( limb_t *r, const limb_t *a, size_t n, limb_t w )
+{
+	size_t i = 0;
+	dlimb_t carry = 0;
+
+#if defined( __SIZEOF_INT128__ ) && LIMB_PAIR_WORDS
+	// Two limbs per multiply: a limb pair times w is below 2^96, so the carry stays one limb
+	for( ; i + 2 <= n; i += 2 )
+	{
+		uint64_t x;
+		memcpy( &x, a + i, sizeof( x ) );
+
+		unsigned __int128 product = (unsigned __int128) x * w + carry;
+		uint64_t low = (uint64_t) product;
+		memcpy( r + i, &low, sizeof( low ) );
+		carry = (dlimb_t) ( product >> 64 );
+	}
+#endif
+
+	for( ; i < n; i++ )
+	{
+		dlimb_t product = (dlimb_t) a[i] * w + carry;
+		r[i] = (limb_t) product;
+		carry = product >> LIMB_BITS;
+	}
+
+	return (limb_t) carry;
+}
+
+/* Limb kernel: r[0..n) += a × w, returns the carry limb out of r[n - 1] */
+limb_t addmul_word( limb_t *r, const limb_t *a, size_t n, limb_t w )
+{
+	size_t i = 0;
+	dlimb_t carry = 0;
+
+#if defined( __SIZEOF_INT128__ ) && LIMB_PAIR_WORDS
+	for( ; i + 2 <= n; i += 2 )
+	{
+		uint64_t x, y;
+		memcpy( &x, a + i, sizeof( x ) );
+		memcpy( &y, r + i, sizeof( y ) );
+
+		unsigned __int128 product = (unsigned __int128) x * w + y + carry;
+		uint64_t low = (uint64_t) product;
+		memcpy( r + i, &low, sizeof( low ) );
+		carry = (dlimb_t) ( product >> 64 );
+	}
+#endif
+
+	for( ; i < n; i++ )
+	{
+		// Product will be updated with carry and existing value at result limb (never overflows two limbs)
+		dlimb_t product = (dlimb_t) a[i] * w + r[i] + carry;
+		r[i] = (limb_t) product;
+		carry = product >> LIMB_BITS;
+	}
+
+	return (limb_t) carry;
+}
+
+/* In place: num = num × w for a machine word w */
+Status mul_small( Bignum *num, limb_t w )
 {
-	
-	// Find length of both numbers
-	int len1 = 0,
-		len2 = 0;
+	STAT_SCOPE( STAT_MUL_SMALL );
 
-	for( Dlist *t = *tail1; t; t = t -> prev ) len1++;
-	for( Dlist *t = *tail2; t; t = t -> prev ) len2++;
+	if( w == 0 || num -> len == 0 )
+	{
+		num -> len = 0;
+		return SUCCESS;
+	}
+
+	if( reserve_number( num, num -> len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	limb_t carry = mul_word( num -> limbs, num -> limbs, num -> len, w );
+	if( carry )
+		num -> limbs[ num -> len++ ] = carry;
+
+	return SUCCESS;
+}
 
-	// Create result list initialised with zeroes and maximum possible digits will be sum of both lengths
-	for( int i = 0; i < len1 + len2; i++ )
-		insert_at_first( headR, tailR, 0 );
+/* Fused: acc = acc + b × c. acc must not alias b or c. */
+Status mul_add( Bignum *acc, const Bignum *b, const Bignum *c )
+{
+	STAT_SCOPE( STAT_MUL_ADD );
 
-	Dlist *temp2 = *tail2;
-	Dlist *tempR_start = *tailR;
+	if( b -> len == 0 || c -> len == 0 )
+		return SUCCESS;
 
-	while( temp2 )
+	// Let c be the shorter factor
+	if( b -> len < c -> len )
 	{
-		int carry = 0;
-		Dlist *temp1 = *tail1;
-		Dlist *tempR = tempR_start;
+		const Bignum *t = b; b = c; c = t;
+	}
+
+	size_t len = b -> len + c -> len;
+	if( acc -> len > len )
+		len = acc -> len;
 
-		while( temp1 )
+	if( reserve_number( acc, len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	memset( acc -> limbs + acc -> len, 0, ( len + 1 - acc -> len ) * sizeof( limb_t ) );
+	acc -> len = len + 1;
+
+	if( c -> len < karatsuba_threshold )
+	{
+		// Short factor: accumulate its rows straight into acc, no product is ever stored
+		for( size_t j = 0; j < c -> len; j++ )
 		{
-			// Product will be updated with carry and existing value at result node
-			int product = ( temp1 -> data * temp2 -> data ) + tempR -> data + carry;
+			limb_t carry = addmul_word( acc -> limbs + j, b -> limbs, b -> len, c -> limbs[j] );
+			add_limbs( acc -> limbs + j + b -> len, acc -> limbs + j + b -> len, len + 1 - j - b -> len, &carry, 1 );
+		}
+	}
+	else
+	{
+		// Long factors: one scratch product from the fast kernels, then a single carry pass
+		limb_t *product = apc_alloc( ( b -> len + c -> len ) * sizeof( limb_t ) );
+		if( product == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			trim_number( acc );
+			return FAILURE;
+		}
 
-			tempR -> data = product % 10;
-			carry = product / 10;
+		Status status = mul_limbs( product, b -> limbs, b -> len, c -> limbs, c -> len );
+		if( status == SUCCESS )
+			add_limbs( acc -> limbs, acc -> limbs, len + 1, product, b -> len + c -> len );
 
-			// Traverse both lists to next nodes ( towards MSB ) 
-			temp1 = temp1 -> prev;
-			tempR = tempR -> prev;
+		apc_free( product );
+		if( status != SUCCESS )
+		{
+			trim_number( acc );
+			return FAILURE;
+		}
+	}
+
+	trim_number( acc );
+	return SUCCESS;
+}
+
+/* Unbalanced operands (an >= 2 × bn): multiply bn-limb blocks of a with b and add them in at their offsets */
+static Status mul_unbalanced( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	limb_t *block = apc_alloc( 2 * bn * sizeof( limb_t ) );
+	if( block == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+
+	size_t rn = an + bn;
+	memset( r, 0, rn * sizeof( limb_t ) );
 
+	for( size_t off = 0; off < an; off += bn )
+	{
+		size_t cn = an - off < bn ? an - off : bn;
+
+		if( mul_limbs( block, b, bn, a + off, cn ) != SUCCESS )
+		{
+			apc_free( block );
+			return FAILURE;
 		}
 
-		// If carry is remaining, add it to the next result node before next multiplication
-		if( carry )
-			tempR -> data += carry;
+		// Block product never carries out of the final result
+		add_limbs( r + off, r + off, rn - off, block, bn + cn );
+	}
+
+	apc_free( block );
+	return SUCCESS;
+}
+
+static void run_mul_jobs( void *ctx, size_t lo, size_t hi )
+{
+	Mul_job *jobs = ctx;
+
+	for( size_t i = lo; i < hi; i++ )
+		jobs[i].status = mul_limbs( jobs[i].r, jobs[i].a, jobs[i].an, jobs[i].b, jobs[i].bn );
+}
 
-		// Move to next digit of second number and adjust starting position in result list
-		temp2 = temp2 -> prev;
-		tempR_start = tempR_start -> prev;
+/* Independent products, spread over threads: SUCCESS only if every one of them succeeded */
+Status mul_jobs( Mul_job *jobs, size_t count )
+{
+	parallel_for( count, run_mul_jobs, jobs );
+
+	for( size_t i = 0; i < count; i++ )
+	{
+		if( jobs[i].status != SUCCESS )
+			return FAILURE;
 	}
 
-	// Remove leading zeroes from result
-	while( (*headR)->next && (*headR)->data == 0 )
-        delete_at_first( headR, tailR );
-		
 	return SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,317 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : div_newton / reciprocal_init / reciprocal_divide / reciprocal_free
+ * Description      : Divides two large numbers through a Newton-iteration reciprocal of the divisor. The reciprocal
+ *                    X = floor(B^(2n) / b) of the n-limb (normalized) divisor is built recursively: the reciprocal of the top
+ *                    half of the divisor is scaled up and refined with one Newton step, which doubles its precision, and a
+ *                    short correction loop makes it exact. The dividend is then processed as digits of n limbs (long division
+ *                    in base B^n), where each quotient digit costs two multiplications instead of n × n limb operations.
+ *
+ * Prototype        : Status div_newton( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem );
+ *                    Status reciprocal_init( Reciprocal *R, const Bignum *divisor );
+ *                    Status reciprocal_divide( const Bignum *num, const Reciprocal *R, Bignum *quot, Bignum *rem );
+ *                    void reciprocal_free( Reciprocal *R );
+ *
+ * Input Parameters : num1   -> Dividend (num1 > num2).
+ *                    num2   -> Divisor (non-zero).
+ *                    quot   -> Number receiving the quotient.
+ *                    rem    -> Number receiving the remainder.
+ *
+ * Return Value     : SUCCESS -> If quotient and remainder were computed.
+ *                    FAILURE -> If memory allocation fails in any of the multiplications.
+ *
+ * Algorithm        :
+ *                    1. Normalize: shift both numbers left so the divisor's top limb has its high bit set.
+ *                    2. reciprocal(): X = floor(B^(2n) / b)
+ *                         a. n small → Algorithm D on B^(2n) / b.
+ *                         b. Otherwise Y = reciprocal(top h = floor(n/2) + 1 limbs of b), X0 = Y · B^(n-h).
+ *                         c. Newton step X1 = X0 + X0 · (B^(2n) - b · X0) / B^(2n), computed on the short operands:
+ *                            b · Y instead of b · X0, and only the top limbs of the error term.
+ *                         d. Outermost level only: correct X1 until 0 <= B^(2n) - b · X1 < b. Inner levels stay a few
+ *                            units off, which the next Newton step absorbs.
+ *                    3. For each n-limb digit A_i of the dividend from the top:
+ *                         a. cur = R · B^n + A_i            (R is the running remainder, R < b)
+ *                         b. Q_i = floor(floor(cur / B^(n-1)) · X / B^(n+1))
+ *                                                          (Barrett estimate: never above the true digit, at most two below)
+ *                         c. R = cur - Q_i · b, then fix up while R >= b.
+ *                    4. Shift the final remainder back right.
+ *
+ * Notes            :
+ *                    • Cost is a constant number of n-limb multiplications per n quotient limbs, so division inherits the
+ *                      Karatsuba / Toom-3 / NTT speed of multiplication().
+ *                    • Selected by divide_numbers() once both divisor and quotient reach div_newton_threshold limbs.
+ *                    • reciprocal_init() / reciprocal_divide() split steps 1-2 from 3-4, so callers dividing many numbers by
+ *                      the same divisor (radix conversion) invert it only once.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+/* Reciprocals of at most this many limbs are computed directly with Algorithm D */
+#define RECIPROCAL_BASECASE 16
+
+/* dst = src << shift bits, 0 <= shift < LIMB_BITS */
+static Status shift_bits( Bignum *dst, const Bignum *src, unsigned shift )
+{
+	if( reserve_number( dst, src -> len + 1 ) != SUCCESS )
+		return FAILURE;
+
+	if( shift )
+		dst -> limbs[ src -> len ] = lshift_limbs( dst -> limbs, src -> limbs, src -> len, shift );
+	else
+	{
+		memcpy( dst -> limbs, src -> limbs, src -> len * sizeof( limb_t ) );
+		dst -> limbs[ src -> len ] = 0;
+	}
+
+	dst -> len = src -> len + 1;
+	trim_number( dst );
+
+	return SUCCESS;
+}
+
+/* X = floor( B^(2n) / b ) for a normalized n-limb b; inner levels (exact = 0) may be a few units off */
+static Status reciprocal( const Bignum *b, Bignum *X, int exact )
+{
+	size_t n = b -> len;
+	Status status = SUCCESS;
+
+	Bignum P, T, E, D;
+	init_number( &P );
+	init_number( &T );
+	init_number( &E );
+	init_number( &D );
+
+	if( set_base_power( &P, 2 * n ) != SUCCESS )
+		return FAILURE;
+
+	// Small case: exact quotient by Algorithm D
+	if( n <= RECIPROCAL_BASECASE )
+	{
+		if( reserve_number( X, n + 2 ) != SUCCESS || reserve_number( &T, n ) != SUCCESS
+			|| div_knuth( X -> limbs, T.limbs, P.limbs, 2 * n + 1, b -> limbs, n ) != SUCCESS )
+			status = FAILURE;
+		else
+		{
+			X -> len = n + 2;
+			trim_number( X );
+		}
+
+		free_number( &P );
+		free_number( &T );
+		return status;
+	}
+
+	// Reciprocal of the top half plus a guard limb, the view shares the divisor's limbs: Y = floor( B^(2h) / top ), X0 = Y · B^(n-h)
+	size_t h = n / 2 + 1,
+		   s = n - h - 2;
+	Bignum top = { b -> limbs + n - h, h, h },
+		   Y;
+	init_number( &Y );
+
+	status = reciprocal( &top, &Y, 0 );
+
+	// Newton step on the short operands: b · X0 = (b · Y) · B^(n-h), so E = B^(2n) - b · X0 = (B^(n+h) - b · Y) · B^(n-h)
+	if( status == SUCCESS )
+		status = multiplication( b, &Y, &T );
+
+	if( status == SUCCESS )
+		status = set_base_power( &P, n + h );
+
+	if( status == SUCCESS )
+	{
+		int below = Find_largest( &T, &P ) != LARGE_1;
+
+		if( below )
+			status = subtraction( &P, &T, &E );
+		else
+			status = subtraction( &T, &P, &E );
+
+		// X0 · E / B^(2n) = Y · E' / B^(2h); only the top limbs of E' matter, the dropped ones cost at most a unit or two
+		shift_number_down( &E, s );
+
+		if( status == SUCCESS )
+			status = multiplication( &Y, &E, &D );
+
+		if( status == SUCCESS )
+		{
+			shift_number_down( &D, 2 * h - s );
+			status = shift_number_up( &Y, n - h );
+		}
+
+		if( status == SUCCESS )
+		{
+			if( below )
+				status = addition( &Y, &D, X );
+			else
+				status = subtraction( &Y, &D, X );
+		}
+	}
+
+	free_number( &Y );
+
+	// Newton squares the error away, so only the outermost level pays for the full product b · X
+	if( status == SUCCESS && exact )
+		status = set_base_power( &P, 2 * n );
+
+	// Correction: make 0 <= B^(2n) - b · X < b
+	if( status == SUCCESS && exact )
+		status = multiplication( b, X, &T );
+
+	while( status == SUCCESS && exact && Find_largest( &T, &P ) == LARGE_1 )
+	{
+		subtract_one( X );
+		status = sub_from( &T, b );
+	}
+
+	if( status == SUCCESS && exact )
+		status = subtraction( &P, &T, &E );
+
+	while( status == SUCCESS && exact && Find_largest( &E, b ) != LARGE_2 )
+	{
+		status = increment_number( X );
+		if( status == SUCCESS )
+			status = sub_from( &E, b );
+	}
+
+	free_number( &P );
+	free_number( &T );
+	free_number( &E );
+	free_number( &D );
+
+	return status;
+}
+
+Status reciprocal_init( Reciprocal *R, const Bignum *divisor )
+{
+	STAT_SCOPE( STAT_RECIPROCAL_INIT );
+
+	R -> shift = 0;
+	for( limb_t top = divisor -> limbs[ divisor -> len - 1 ]; !( top & 0x80000000u ); top <<= 1 )
+		R -> shift++;
+
+	init_number( &R -> b );
+	init_number( &R -> X );
+
+	// 1. Normalize and 2. invert the divisor
+	if( shift_bits( &R -> b, divisor, R -> shift ) != SUCCESS || reciprocal( &R -> b, &R -> X, 1 ) != SUCCESS )
+	{
+		reciprocal_free( R );
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+void reciprocal_free( Reciprocal *R )
+{
+	free_number( &R -> b );
+	free_number( &R -> X );
+}
+
+Status reciprocal_divide( const Bignum *num, const Reciprocal *R, Bignum *quot, Bignum *rem )
+{
+	STAT_SCOPE( STAT_RECIPROCAL_DIVIDE );
+
+	const Bignum *b = &R -> b,
+				 *X = &R -> X;
+	size_t n = b -> len;
+
+	Bignum a, cur, Q, T;
+	init_number( &a );
+	init_number( &cur );
+	init_number( &Q );
+	init_number( &T );
+
+	// 1. Normalize the dividend with the divisor's shift
+	Status status = shift_bits( &a, num, R -> shift );
+
+	size_t digits = a.len ? ( a.len + n - 1 ) / n : 1;
+
+	if( status == SUCCESS )
+		status = reserve_number( quot, digits * n );
+
+	if( status == SUCCESS )
+		status = reserve_number( &cur, 2 * n );
+
+	rem -> len = 0;
+
+	// 3. Long division in base B^n, rem holds the running remainder
+	for( size_t i = digits; status == SUCCESS && i-- > 0; )
+	{
+		size_t off = i * n,
+			   cn = a.len > off ? ( a.len - off < n ? a.len - off : n ) : 0;
+
+		// cur = R · B^n + A_i
+		if( cn )
+			memcpy( cur.limbs, a.limbs + off, cn * sizeof( limb_t ) );
+		memset( cur.limbs + cn, 0, ( n - cn ) * sizeof( limb_t ) );
+		if( rem -> len )
+			memcpy( cur.limbs + n, rem -> limbs, rem -> len * sizeof( limb_t ) );
+		cur.len = n + rem -> len;
+		trim_number( &cur );
+
+		// Q_i = floor( floor( cur / B^(n-1) ) · X / B^(n+1) ), only the top n + 1 limbs of cur take part
+		if( cur.len > n - 1 )
+		{
+			Bignum top = { cur.limbs + n - 1, cur.len - ( n - 1 ), cur.len - ( n - 1 ) };
+
+			status = multiplication( &top, X, &T );
+			if( status != SUCCESS )
+				break;
+			shift_number_down( &T, n + 1 );
+		}
+		else
+			T.len = 0;
+
+		// R = cur - Q_i · b, fixed up while R >= b
+		status = multiplication( &T, b, &Q );
+		if( status == SUCCESS )
+			status = subtraction( &cur, &Q, rem );
+
+		while( status == SUCCESS && Find_largest( rem, b ) != LARGE_2 )
+		{
+			status = increment_number( &T );
+			if( status == SUCCESS )
+				status = sub_from( rem, b );
+		}
+
+		// Quotient digit goes to its n-limb slot
+		if( T.len )
+			memcpy( quot -> limbs + off, T.limbs, T.len * sizeof( limb_t ) );
+		memset( quot -> limbs + off + T.len, 0, ( n - T.len ) * sizeof( limb_t ) );
+	}
+
+	if( status == SUCCESS )
+	{
+		quot -> len = digits * n;
+		trim_number( quot );
+
+		// 4. Un-normalize the remainder
+		if( R -> shift && rem -> len )
+		{
+			rshift_limbs( rem -> limbs, rem -> limbs, rem -> len, R -> shift );
+			trim_number( rem );
+		}
+	}
+
+	free_number( &a );
+	free_number( &cur );
+	free_number( &Q );
+	free_number( &T );
+
+	return status;
+}
+
+Status div_newton( const Bignum *num1, const Bignum *num2, Bignum *quot, Bignum *rem )
+{
+	STAT_SCOPE( STAT_DIV_NEWTON );
+
+	Reciprocal R;
+
+	if( reciprocal_init( &R, num2 ) != SUCCESS )
+		return FAILURE;
+
+	Status status = reciprocal_divide( num1, &R, quot, rem );
+
+	reciprocal_free( &R );
+	return status;
+}
\ No newline at end of file
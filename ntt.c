@@ -0,0 +1,371 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : mul_ntt
+ * Description      : Multiplies two limb arrays with a multi-prime Number Theoretic Transform. The limbs of both operands are
+ *                    taken as the coefficients of two polynomials and convolved exactly modulo three NTT-friendly primes below
+ *                    2^31. The three residues of every convolution coefficient are recombined with the Chinese Remainder Theorem
+ *                    (Garner's form) and the resulting ~89-bit coefficients are carried into the limb result. All arithmetic is
+ *                    integer arithmetic, so unlike a floating-point FFT there is no rounding error to bound.
+ *
+ * Prototype        : Status mul_ntt( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+ *
+ * Input Parameters : r      -> Result array with room for an + bn limbs (must not overlap a or b).
+ *                    a, an  -> First operand limbs and limb count.
+ *                    b, bn  -> Second operand limbs and limb count (an + bn <= NTT_MAX_LENGTH).
+ *
+ * Return Value     : SUCCESS -> If the product was computed.
+ *                    FAILURE -> If memory allocation fails for the transform buffers.
+ *
+ * Algorithm        :
+ *                    1. n = smallest power of two >= an + bn - 1 (the convolution length).
+ *                    2. For each prime p:
+ *                         a. Reduce a and b modulo p into zero padded length n arrays.
+ *                         b. Forward transform both (a single transform when squaring).
+ *                         c. Multiply point-wise, inverse transform and scale by 1/n.
+ *                    3. For every coefficient, rebuild x = v1 + p1·v2 + p1·p2·v3 from the three residues and
+ *                       add it to the running carry; the low 32 bits become the result limb.
+ *
+ * Notes            :
+ *                    • Time Complexity: O(n log n).
+ *                    • Primes 2013265921, 469762049 and 754974721 multiply to ~2^89.2, above the largest possible
+ *                      coefficient (n / 2) × (2^32 - 1)^2 < 2^88 for n <= 2^24; the smallest 2-adicity limits n to 2^24.
+ *                    • Modular products use 32-bit Montgomery multiplication; twiddle factors are kept in Montgomery form so
+ *                      the data itself stays in normal form.
+ *                    • With more than one thread, the three primes are convolved in parallel, each butterfly stage of long
+ *                      transforms is split over threads, and Garner's step runs per coefficient in parallel; only the final
+ *                      carry pass is sequential.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+/* Transforms of at least this length spread each butterfly stage over threads */
+#define NTT_PARALLEL_LENGTH ( (size_t) 1 << 15 )
+
+typedef struct
+{
+	uint32_t p;			// Prime modulus, below 2^31
+	uint32_t g;			// Primitive root modulo p
+	uint32_t pinv;		// -p^-1 mod 2^32
+	uint32_t r1;		// 2^32 mod p, Montgomery form of 1
+	uint32_t r2;		// 2^64 mod p, converts into Montgomery form
+} Ntt_prime;
+
+/* Montgomery product a·b·2^-32 mod p */
+static inline uint32_t mont_mul( uint32_t a, uint32_t b, const Ntt_prime *P )
+{
+	uint64_t t = (uint64_t) a * b;
+	uint32_t m = (uint32_t) t * P -> pinv;
+	uint32_t u = (uint32_t) ( ( t + (uint64_t) m * P -> p ) >> 32 );
+
+	return u >= P -> p ? u - P -> p : u;
+}
+
+/* base^e for a base in Montgomery form, result in Montgomery form */
+static uint32_t mont_pow( uint32_t base, uint64_t e, const Ntt_prime *P )
+{
+	uint32_t result = P -> r1;
+
+	while( e )
+	{
+		if( e & 1 )
+			result = mont_mul( result, base, P );
+		base = mont_mul( base, base, P );
+		e >>= 1;
+	}
+
+	return result;
+}
+
+static void ntt_prime_init( Ntt_prime *P, uint32_t p, uint32_t g )
+{
+	P -> p = p;
+	P -> g = g;
+
+	// Newton iteration doubles the correct low bits of p^-1 every round
+	uint32_t inv = p;
+	for( int i = 0; i < 5; i++ )
+		inv *= 2 - p * inv;
+	P -> pinv = -inv;
+
+	P -> r1 = (uint32_t) ( ( (uint64_t) 1 << 32 ) % p );
+	P -> r2 = (uint32_t) ( (uint64_t) P -> r1 * P -> r1 % p );
+}
+
+/* One butterfly stage of half-length half, shared by the worker threads of a parallel transform */
+typedef struct
+{
+	uint32_t *a;
+	const uint32_t *roots;
+	const Ntt_prime *P;
+	size_t half, step;
+} Ntt_stage;
+
+/* Butterflies lo..hi of a stage: butterfly t pairs a[i + j] with a[i + j + half] */
+static void ntt_stage_range( void *ctx, size_t lo, size_t hi )
+{
+	const Ntt_stage *S = ctx;
+	uint32_t p = S -> P -> p;
+
+	for( size_t t = lo; t < hi; t++ )
+	{
+		size_t j = t & ( S -> half - 1 ),
+			   i = ( t - j ) * 2;
+
+		uint32_t u = S -> a[i + j];
+		uint32_t v = mont_mul( S -> a[i + j + S -> half], S -> roots[j * S -> step], S -> P );
+
+		S -> a[i + j] = u + v >= p ? u + v - p : u + v;
+		S -> a[i + j + S -> half] = u >= v ? u - v : u + p - v;
+	}
+}
+
+/* In-place iterative radix-2 transform; roots[j] = w^j in Montgomery form for j < n / 2 */
+static void ntt_transform( uint32_t *a, size_t n, const uint32_t *roots, const Ntt_prime *P )
+{
+	uint32_t p = P -> p;
+
+	// Bit reversal permutation
+	for( size_t i = 1, j = 0; i < n; i++ )
+	{
+		size_t bit = n >> 1;
+		for( ; j & bit; bit >>= 1 )
+			j ^= bit;
+		j ^= bit;
+
+		if( i < j )
+		{
+			uint32_t t = a[i];
+			a[i] = a[j];
+			a[j] = t;
+		}
+	}
+
+	// Large transforms: every stage's n / 2 butterflies are independent, spread them over threads
+	if( n >= NTT_PARALLEL_LENGTH && parallel_threads() > 1 )
+	{
+		for( size_t len = 2; len <= n; len <<= 1 )
+		{
+			Ntt_stage stage = { a, roots, P, len / 2, n / len };
+			parallel_for( n / 2, ntt_stage_range, &stage );
+		}
+		return;
+	}
+
+	// Cooley-Tukey butterflies
+	for( size_t len = 2; len <= n; len <<= 1 )
+	{
+		size_t half = len / 2,
+			   step = n / len;
+
+		for( size_t i = 0; i < n; i += len )
+		{
+			for( size_t j = 0; j < half; j++ )
+			{
+				uint32_t u = a[i + j];
+				uint32_t v = mont_mul( a[i + j + half], roots[j * step], P );
+
+				a[i + j] = u + v >= p ? u + v - p : u + v;
+				a[i + j + half] = u >= v ? u - v : u + p - v;
+			}
+		}
+	}
+}
+
+/* Fill roots[j] = w^j (Montgomery form), j < n / 2 */
+static void ntt_roots( uint32_t *roots, size_t n, uint32_t w, const Ntt_prime *P )
+{
+	roots[0] = P -> r1;
+	for( size_t j = 1; j < n / 2; j++ )
+		roots[j] = mont_mul( roots[j - 1], w, P );
+}
+
+/* Convolution of a and b modulo one prime, left in out[0..n) */
+static void ntt_convolve( uint32_t *out, uint32_t *temp, uint32_t *roots, const limb_t *a, size_t an,
+						  const limb_t *b, size_t bn, size_t n, const Ntt_prime *P )
+{
+	int square = ( a == b && an == bn );
+
+	// Primitive n-th root of unity and its inverse, Montgomery form
+	uint32_t g = mont_mul( P -> g, P -> r2, P );
+	uint32_t w = mont_pow( g, ( P -> p - 1 ) / n, P );
+	uint32_t w_inv = mont_pow( w, n - 1, P );
+
+	for( size_t i = 0; i < an; i++ )
+		out[i] = a[i] % P -> p;
+	memset( out + an, 0, ( n - an ) * sizeof( uint32_t ) );
+
+	ntt_roots( roots, n, w, P );
+	ntt_transform( out, n, roots, P );
+
+	if( square )
+	{
+		for( size_t i = 0; i < n; i++ )
+			out[i] = mont_mul( out[i], out[i], P );
+	}
+	else
+	{
+		for( size_t i = 0; i < bn; i++ )
+			temp[i] = b[i] % P -> p;
+		memset( temp + bn, 0, ( n - bn ) * sizeof( uint32_t ) );
+
+		ntt_transform( temp, n, roots, P );
+
+		for( size_t i = 0; i < n; i++ )
+			out[i] = mont_mul( out[i], temp[i], P );
+	}
+
+	ntt_roots( roots, n, w_inv, P );
+	ntt_transform( out, n, roots, P );
+
+	// Point-wise products left a 2^-32 factor behind; scale = n^-1 · 2^64 cancels it and the transform's n
+	uint32_t n_inv = mont_pow( mont_mul( (uint32_t) ( n % P -> p ), P -> r2, P ), P -> p - 2, P );
+	uint32_t scale = mont_mul( n_inv, P -> r2, P );
+
+	for( size_t i = 0; i < n; i++ )
+		out[i] = mont_mul( out[i], scale, P );
+}
+
+/* Plain modular exponentiation for the CRT constants */
+static uint64_t pow_mod( uint64_t base, uint64_t e, uint64_t m )
+{
+	uint64_t result = 1;
+	base %= m;
+
+	while( e )
+	{
+		if( e & 1 )
+			result = result * base % m;
+		base = base * base % m;
+		e >>= 1;
+	}
+
+	return result;
+}
+
+/* Shared state of one multiplication, read by the per-prime and per-coefficient workers */
+typedef struct
+{
+	Ntt_prime P[3];
+	uint32_t *res[3], *temp[3], *roots[3];
+	const limb_t *a, *b;
+	size_t an, bn, n;
+	uint64_t p1_inv_p2, p12_inv_p3;
+} Ntt_job;
+
+static void ntt_convolve_range( void *ctx, size_t lo, size_t hi )
+{
+	Ntt_job *J = ctx;
+
+	for( size_t k = lo; k < hi; k++ )
+		ntt_convolve( J -> res[k], J -> temp[k], J -> roots[k], J -> a, J -> an, J -> b, J -> bn, J -> n, &J -> P[k] );
+}
+
+/* Garner's CRT for coefficients lo..hi, the ~89-bit value x replaces the residues as three 32-bit words */
+static void ntt_garner_range( void *ctx, size_t lo, size_t hi )
+{
+	Ntt_job *J = ctx;
+	uint64_t p1 = J -> P[0].p, p2 = J -> P[1].p, p3 = J -> P[2].p;
+	uint64_t p12 = p1 * p2;
+	uint64_t p12_lo = p12 & 0xFFFFFFFFu,
+			 p12_hi = p12 >> 32;
+
+	for( size_t i = lo; i < hi; i++ )
+	{
+		uint64_t v1 = J -> res[0][i];
+		uint64_t v2 = ( J -> res[1][i] + p2 - v1 % p2 ) % p2 * J -> p1_inv_p2 % p2;
+		uint64_t s = v1 + p1 * v2;
+		uint64_t v3 = ( J -> res[2][i] + p3 - s % p3 ) % p3 * J -> p12_inv_p3 % p3;
+
+		// x = s + p12 · v3, with p12 · v3 split across the 64-bit boundary
+		uint64_t low = p12_lo * v3;
+		uint64_t mid = p12_hi * v3;
+
+		uint64_t x_lo = low + ( mid << 32 );
+		uint64_t x_hi = ( mid >> 32 ) + ( x_lo < low );
+
+		x_lo += s;
+		x_hi += ( x_lo < s );
+
+		J -> res[0][i] = (uint32_t) x_lo;
+		J -> res[1][i] = (uint32_t) ( x_lo >> 32 );
+		J -> res[2][i] = (uint32_t) x_hi;
+	}
+}
+
+Status mul_ntt( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	STAT_SCOPE( STAT_NTT );
+
+	Ntt_job J;
+	ntt_prime_init( &J.P[0], 2013265921u, 31 );
+	ntt_prime_init( &J.P[1], 469762049u, 3 );
+	ntt_prime_init( &J.P[2], 754974721u, 11 );
+
+	size_t rn = an + bn;
+	size_t n = 1;
+	while( n < rn - 1 )
+		n <<= 1;
+	if( n < 2 )
+		n = 2;
+
+	// Three residue arrays, then transform scratch and a root table: one shared set, or one per prime when they run in parallel
+	int sets = parallel_threads() > 1 ? 3 : 1;
+
+	uint32_t *block = apc_alloc( ( 3 * n + sets * ( n + n / 2 ) ) * sizeof( uint32_t ) );
+	if( block == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+
+	for( int k = 0; k < 3; k++ )
+	{
+		int set = k % sets;
+
+		J.res[k] = block + k * n;
+		J.temp[k] = block + 3 * n + set * ( n + n / 2 );
+		J.roots[k] = J.temp[k] + n;
+	}
+
+	J.a = a;
+	J.b = b;
+	J.an = an;
+	J.bn = bn;
+	J.n = n;
+
+	if( sets == 3 )
+		parallel_for( 3, ntt_convolve_range, &J );
+	else
+		ntt_convolve_range( &J, 0, 3 );
+
+	// Garner constants
+	uint64_t p1 = J.P[0].p, p2 = J.P[1].p, p3 = J.P[2].p;
+	J.p1_inv_p2 = pow_mod( p1, p2 - 2, p2 );
+	J.p12_inv_p3 = pow_mod( p1 * p2 % p3, p3 - 2, p3 );
+
+	// Coefficients are independent, only the carry pass below is sequential
+	parallel_for( rn - 1, ntt_garner_range, &J );
+
+	// Running carry as a 128-bit value (carry_hi : carry_lo)
+	uint64_t carry_lo = 0, carry_hi = 0;
+
+	for( size_t i = 0; i < rn; i++ )
+	{
+		uint64_t lo = 0, hi = 0;
+
+		if( i < rn - 1 )
+		{
+			lo = J.res[0][i] | ( (uint64_t) J.res[1][i] << 32 );
+			hi = J.res[2][i];
+		}
+
+		lo += carry_lo;
+		hi += carry_hi + ( lo < carry_lo );
+
+		r[i] = (limb_t) lo;
+		carry_lo = ( lo >> 32 ) | ( hi << 32 );
+		carry_hi = hi >> 32;
+	}
+
+	apc_free( block );
+	return SUCCESS;
+}
\ No newline at end of file
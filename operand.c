@@ -0,0 +1,107 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : load_operand
+ * Description      : Operand input. An operand token is either the number itself ("-1234") or "@path", naming a file that
+ *                    holds the number as decimal text. Files are mapped with mmap() and converted straight from the mapping,
+ *                    so a multi-gigabyte digit dump is never copied, never passed through argv (capped by the kernel at a
+ *                    few hundred KB per argument) and never NUL terminated. The digits are validated by the vectorized
+ *                    check_digits() (digits.c) before conversion.
+ *
+ * Prototype        : Status load_operand( const char *token, Bignum *num, char *sign );
+ *
+ * Input Parameters : token  -> Operand token, already checked by Validate_arguments() unless it starts with '@'.
+ *                    num    -> Number receiving the magnitude.
+ *                    sign   -> Receives '+' or '-'.
+ *
+ * Return Value     : load_operand -> SUCCESS, NON_NUMERIC (file is not a single signed decimal number), or FAILURE (the
+ *                                    file cannot be opened or mapped, or memory allocation failed).
+ *
+ * File Format      :
+ *                    • Optional leading and trailing whitespace (a final newline is expected from most tools).
+ *                    • Optional '+' or '-', then at least one digit and nothing else.
+ *
+ * Notes            :
+ *                    • The mapping is read sequentially once (MADV_SEQUENTIAL) and released before the calculation runs,
+ *                      so only the limb array stays resident: about 0.42 bytes per input digit.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Signed decimal text in p[0..n) → num and sign */
+static Status parse_text( const char *p, size_t n, Bignum *num, char *sign )
+{
+	while( n && isspace( (unsigned char) p[0] ) )
+	{
+		p++;
+		n--;
+	}
+	while( n && isspace( (unsigned char) p[n - 1] ) )
+		n--;
+
+	*sign = '+';
+	if( n && ( p[0] == '+' || p[0] == '-' ) )
+	{
+		*sign = p[0];
+		p++;
+		n--;
+	}
+
+	if( n == 0 || check_digits( p, n ) == NON_NUMERIC )
+		return NON_NUMERIC;
+
+	return decimal_to_number( num, p, n );
+}
+
+Status load_operand( const char *token, Bignum *num, char *sign )
+{
+	STAT_SCOPE( STAT_LOAD_OPERAND );
+
+	if( token[0] != '@' )
+	{
+		*sign = ( token[0] == '-' ) ? '-' : '+';
+		return String_to_number( num, token );
+	}
+
+	int fd = open( token + 1, O_RDONLY );
+	if( fd < 0 )
+	{
+		perror("INFO : Cannot open operand file");
+		return FAILURE;
+	}
+
+	struct stat st;
+	if( fstat( fd, &st ) != 0 )
+	{
+		perror("INFO : Cannot open operand file");
+		close( fd );
+		return FAILURE;
+	}
+
+	// An empty file cannot be mapped, and holds no number either
+	if( st.st_size == 0 )
+	{
+		close( fd );
+		return NON_NUMERIC;
+	}
+
+	size_t size = (size_t) st.st_size;
+	char *text = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+
+	if( text == MAP_FAILED )
+	{
+		perror("INFO : Cannot map operand file");
+		return FAILURE;
+	}
+
+	madvise( text, size, MADV_SEQUENTIAL );
+
+	Status status = parse_text( text, size, num, sign );
+
+	munmap( text, size );
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : parallel_for
+ * Description      : Fork-join helper used to spread one large multiplication over several cores. The index range [0, n) is
+ *                    cut into contiguous pieces, helper threads run all pieces but the last, the calling thread runs the last
+ *                    piece itself and then joins the helpers. A process-wide budget of mul_threads - 1 helper threads is shared
+ *                    by all callers, so nested calls (a Toom-3 sub-product that itself goes parallel, a transform inside one of
+ *                    three parallel NTT primes) never oversubscribe the machine: when no helper is free the work simply runs
+ *                    serially on the calling thread.
+ *
+ * Prototype        : void parallel_for( size_t n, Range_fn body, void *ctx );
+ *
+ * Input Parameters : n      -> Number of independent indices.
+ *                    body   -> Called as body( ctx, lo, hi ) for disjoint ranges covering [0, n).
+ *                    ctx    -> Shared, read-mostly context handed to every call.
+ *
+ * Special Cases    :
+ *                    • mul_threads = 1, n < 2 or an exhausted helper budget → body( ctx, 0, n ) on the calling thread.
+ *                    • A helper that cannot be created gives its range back to the calling thread.
+ *
+ * Notes            :
+ *                    • mul_threads = 0 (the default) means every online core; the driver's -j option overrides it.
+ *                    • parallel_threshold (limbs) is the smaller operand size from which multiplication kernels call this.
+ *                    • Helper threads have no arena open, so their scratch buffers come from malloc().
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+/* Most helper threads one parallel_for() call starts */
+#define MAX_HELPERS 63
+
+size_t mul_threads = 0;
+size_t parallel_threshold = PARALLEL_THRESHOLD;
+
+/* Helper threads currently running, across all parallel_for() calls */
+static atomic_size_t helpers_busy;
+
+/* Online core count, looked up once */
+static atomic_size_t online_cores;
+
+typedef struct
+{
+	pthread_t id;
+	Range_fn body;
+	void *ctx;
+	size_t lo, hi;
+} Range_job;
+
+static void *range_main( void *arg )
+{
+	Range_job *job = arg;
+	job -> body( job -> ctx, job -> lo, job -> hi );
+	return NULL;
+}
+
+/* Threads a multiplication may use, resolving 0 to the online core count */
+size_t parallel_threads( void )
+{
+	if( mul_threads )
+		return mul_threads;
+
+	size_t cores = atomic_load( &online_cores );
+	if( cores == 0 )
+	{
+		long online = sysconf( _SC_NPROCESSORS_ONLN );
+		cores = online > 0 ? (size_t) online : 1;
+		atomic_store( &online_cores, cores );
+	}
+
+	return cores;
+}
+
+/* Claim up to want helpers from the shared budget, returns how many were granted */
+static size_t reserve_helpers( size_t want )
+{
+	size_t limit = parallel_threads() - 1;
+	size_t busy = atomic_load( &helpers_busy );
+
+	while( 1 )
+	{
+		size_t take = busy >= limit ? 0 : limit - busy < want ? limit - busy : want;
+		if( take == 0 || atomic_compare_exchange_weak( &helpers_busy, &busy, busy + take ) )
+			return take;
+	}
+}
+
+void parallel_for( size_t n, Range_fn body, void *ctx )
+{
+	size_t helpers = n > 1 ? reserve_helpers( n - 1 < MAX_HELPERS ? n - 1 : MAX_HELPERS ) : 0;
+
+	if( helpers == 0 )
+	{
+		body( ctx, 0, n );
+		return;
+	}
+
+	Range_job jobs[ MAX_HELPERS ];
+	int started[ MAX_HELPERS ];
+	size_t pieces = helpers + 1;
+
+	// Helpers take the first pieces, the calling thread the last one
+	for( size_t i = 0; i < helpers; i++ )
+	{
+		jobs[i].body = body;
+		jobs[i].ctx = ctx;
+		jobs[i].lo = n * i / pieces;
+		jobs[i].hi = n * ( i + 1 ) / pieces;
+		started[i] = pthread_create( &jobs[i].id, NULL, range_main, &jobs[i] ) == 0;
+	}
+
+	body( ctx, n * helpers / pieces, n );
+
+	for( size_t i = 0; i < helpers; i++ )
+	{
+		if( started[i] )
+			pthread_join( jobs[i].id, NULL );
+		else
+			body( ctx, jobs[i].lo, jobs[i].hi );
+	}
+
+	atomic_fetch_sub( &helpers_busy, helpers );
+}
\ No newline at end of file
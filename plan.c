@@ -0,0 +1,596 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : run_plan / plan_compile / plan_run / plan_free
+ * Description      : Compiled expression plans. An expression is compiled once into a flat list of steps over a register file
+ *                    and then evaluated for any number of inputs. Compilation numbers every distinct subterm once, so a
+ *                    repeated subterm is computed once per evaluation. It also fuses "a ^ b % m" into one modular power and
+ *                    "a / b" with "a % b" into one division. Temporaries share registers whose values are no longer needed,
+ *                    and their limb arrays are reused from one evaluation to the next.
+ *
+ * Prototype        : Status run_plan( const char *expression, FILE *in, FILE *out );
+ *                    Status plan_compile( const Expr_node *root, Plan *plan );
+ *                    Status plan_run( Plan *plan, const Bignum **value, char *sign );
+ *                    void plan_free( Plan *plan );
+ *
+ * Input Parameters : expression -> One expression; its variables are the plan's inputs, in order of first appearance.
+ *                    in         -> Stream of input lines, one value (number or "@path") per input, separated by blanks.
+ *                    out        -> Stream receiving one result line per input line.
+ *                    root       -> Parsed expression (expr_parse() with no variable table), without assignments.
+ *                    plan       -> Plan to fill / run; the inputs are loaded into plan -> regs[0 .. input_count).
+ *                    value      -> Receives the result register (valid until the next run).
+ *                    sign       -> Receives '+' or '-' for the result.
+ *
+ * Return Value     : run_plan     -> SUCCESS if the plan compiled and every line was evaluated, FAILURE otherwise
+ *                                    (also for an expression without variables, which --expr evaluates instead).
+ *                    plan_compile -> SUCCESS, or FAILURE for an assignment or when memory allocation fails.
+ *                    plan_run     -> SUCCESS, ZERO_DIVISOR, or FAILURE when memory allocation fails.
+ *
+ * Algorithm (plan_compile):
+ *                    1. Value numbering: the tree is walked in evaluation order. Each input, constant and operation becomes a
+ *                       value; an operation whose operator and operand values match an existing one reuses it (operands of
+ *                       + and x are ordered first, so "a + b" and "b + a" match). A negation costs nothing: it only flips the
+ *                       sign flag of the operand reference.
+ *                    2. Fusion: "x ^ y % m" is numbered as one modular power step (the power is never a value), and a
+ *                       division and a modulus with the same operands become one divmod step writing both registers.
+ *                    3. Registers: inputs, then constants, then temporaries. Each step takes a free temporary for its result
+ *                       and releases its operands after their last use, so the file holds only the values still needed.
+ *
+ * Output Format    : As batch mode, one plain signed decimal or "ERROR: ..." line per input line, blank for a blank line.
+ *
+ * Notes            :
+ *                    • The sign rules are those of the command line: every step calls apply_operator().
+ *                    • A step never writes a register it reads, as apply_operator() requires.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <ctype.h>
+
+/* Operator of each plain step for apply_operator() */
+static const char plan_operator[] = { [PLAN_ADD] = '+', [PLAN_SUB] = '-', [PLAN_MUL] = 'x', [PLAN_DIV] = '/',
+									  [PLAN_MOD] = '%', [PLAN_POW] = '^' };
+
+typedef enum
+{
+	VALUE_INPUT,
+	VALUE_CONSTANT,
+	VALUE_STEP
+} Value_kind;
+
+/* One numbered value while compiling; the reg field of its operands holds value indices */
+typedef struct
+{
+	Value_kind kind;
+	Plan_op op;
+	Plan_ref a, b, c;
+	size_t source;		// Value whose step computes this one: itself, or the divmod it was fused into
+	size_t quot, rem;	// PLAN_DIVMOD: values receiving the quotient and the remainder
+	char *name;			// Input name
+	Bignum num;			// Constant magnitude
+	int used;
+	size_t last_use;	// Last step reading the value
+	size_t reg;
+} Value;
+
+typedef struct
+{
+	Value *v;
+	size_t count, cap;
+} Compiler;
+
+static size_t add_value( Compiler *C, const Value *value )
+{
+	if( C -> count == C -> cap )
+	{
+		size_t cap = C -> cap ? 2 * C -> cap : 16;
+		Value *v = realloc( C -> v, cap * sizeof( Value ) );
+		if( v == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			return SIZE_MAX;
+		}
+
+		C -> v = v;
+		C -> cap = cap;
+	}
+
+	C -> v[ C -> count ] = *value;
+	C -> v[ C -> count ].source = C -> count;
+	return C -> count++;
+}
+
+static int same_ref( Plan_ref x, Plan_ref y )
+{
+	return x.reg == y.reg && x.negate == y.negate;
+}
+
+static Status compile_node( Compiler *C, const Expr_node *node, Plan_ref *out )
+{
+	Value value = { 0 };
+	size_t i;
+
+	out -> negate = 0;
+
+	switch( node -> kind )
+	{
+		case EXPR_NUMBER:
+			// Equal magnitudes share one constant register, the sign goes into the reference
+			out -> negate = ( node -> sign == '-' );
+			for( i = 0; i < C -> count; i++ )
+				if( C -> v[i].kind == VALUE_CONSTANT && Find_largest( &C -> v[i].num, &node -> value ) == EQUAL )
+					break;
+
+			if( i == C -> count )
+			{
+				value.kind = VALUE_CONSTANT;
+				init_number( &value.num );
+				if( copy_number( &node -> value, &value.num ) != SUCCESS
+					|| ( i = add_value( C, &value ) ) == SIZE_MAX )
+				{
+					free_number( &value.num );
+					return FAILURE;
+				}
+			}
+
+			out -> reg = i;
+			return SUCCESS;
+
+		case EXPR_VARIABLE:
+			for( i = 0; i < C -> count; i++ )
+				if( C -> v[i].kind == VALUE_INPUT && strcmp( C -> v[i].name, node -> name ) == 0 )
+					break;
+
+			if( i == C -> count )
+			{
+				value.kind = VALUE_INPUT;
+				if( ( value.name = malloc( strlen( node -> name ) + 1 ) ) == NULL )
+				{
+					perror("INFO : Memory Allocation Failed");
+					return FAILURE;
+				}
+				strcpy( value.name, node -> name );
+
+				if( ( i = add_value( C, &value ) ) == SIZE_MAX )
+				{
+					free( value.name );
+					return FAILURE;
+				}
+			}
+
+			out -> reg = i;
+			return SUCCESS;
+
+		case EXPR_NEGATE:
+		{
+			Status status = compile_node( C, node -> left, out );
+			out -> negate ^= 1;
+			return status;
+		}
+
+		case EXPR_ASSIGN:
+			return FAILURE;
+
+		case EXPR_BINARY:
+			break;
+	}
+
+	value.kind = VALUE_STEP;
+
+	// x ^ y % m: one modular power, the power itself is never built
+	const Expr_node *left = node -> left;
+	if( node -> op == '%' && left -> kind == EXPR_BINARY && left -> op == '^' )
+	{
+		value.op = PLAN_MODPOW;
+		if( compile_node( C, left -> left, &value.a ) != SUCCESS || compile_node( C, left -> right, &value.b ) != SUCCESS
+			|| compile_node( C, node -> right, &value.c ) != SUCCESS )
+			return FAILURE;
+	}
+	else
+	{
+		value.op = ( node -> op == '+' ) ? PLAN_ADD : ( node -> op == '-' ) ? PLAN_SUB : ( node -> op == 'x' ) ? PLAN_MUL :
+				   ( node -> op == '/' ) ? PLAN_DIV : ( node -> op == '%' ) ? PLAN_MOD : PLAN_POW;
+		if( compile_node( C, left, &value.a ) != SUCCESS || compile_node( C, node -> right, &value.b ) != SUCCESS )
+			return FAILURE;
+
+		// Commutative operators in a fixed operand order, so both spellings number alike
+		if( ( value.op == PLAN_ADD || value.op == PLAN_MUL )
+			&& ( value.b.reg < value.a.reg || ( value.b.reg == value.a.reg && value.b.negate < value.a.negate ) ) )
+		{
+			Plan_ref t = value.a;
+			value.a = value.b;
+			value.b = t;
+		}
+	}
+
+	// Common subexpression: the same operation on the same values is the same value
+	for( i = 0; i < C -> count; i++ )
+	{
+		Value *v = &C -> v[i];
+		if( v -> kind == VALUE_STEP && v -> op == value.op && same_ref( v -> a, value.a ) && same_ref( v -> b, value.b )
+			&& ( value.op != PLAN_MODPOW || same_ref( v -> c, value.c ) ) )
+			break;
+	}
+
+	if( i == C -> count && ( i = add_value( C, &value ) ) == SIZE_MAX )
+		return FAILURE;
+
+	out -> reg = i;
+	return SUCCESS;
+}
+
+/* A division and a modulus of the same operands become one divmod step, placed where the first of them was */
+static void fuse_divmod( Compiler *C )
+{
+	for( size_t i = 0; i < C -> count; i++ )
+	{
+		Value *d = &C -> v[i];
+		if( d -> kind != VALUE_STEP || d -> op != PLAN_DIV )
+			continue;
+
+		for( size_t j = 0; j < C -> count; j++ )
+		{
+			Value *m = &C -> v[j];
+			if( m -> kind != VALUE_STEP || m -> op != PLAN_MOD || !same_ref( d -> a, m -> a ) || !same_ref( d -> b, m -> b ) )
+				continue;
+
+			size_t owner = i < j ? i : j;
+			C -> v[ owner ].op = PLAN_DIVMOD;
+			C -> v[ owner ].quot = i;
+			C -> v[ owner ].rem = j;
+			C -> v[ i < j ? j : i ].source = owner;
+			break;
+		}
+	}
+}
+
+/* Operands read by the step of value i */
+static size_t step_operands( const Value *v, size_t operands[3] )
+{
+	operands[0] = v -> a.reg;
+	operands[1] = v -> b.reg;
+	operands[2] = v -> c.reg;
+
+	return v -> op == PLAN_MODPOW ? 3 : 2;
+}
+
+static Plan_ref register_ref( const Compiler *C, Plan_ref ref )
+{
+	return (Plan_ref) { C -> v[ ref.reg ].reg, ref.negate };
+}
+
+static void free_compiler( Compiler *C )
+{
+	for( size_t i = 0; i < C -> count; i++ )
+	{
+		free( C -> v[i].name );
+		free_number( &C -> v[i].num );
+	}
+
+	free( C -> v );
+}
+
+Status plan_compile( const Expr_node *root, Plan *plan )
+{
+	memset( plan, 0, sizeof( Plan ) );
+
+	Compiler C = { 0 };
+	Plan_ref result;
+	size_t *free_regs = NULL, free_count = 0;
+
+	// 1. Value numbering with the modular power fused in
+	Status status = compile_node( &C, root, &result );
+
+	if( status == SUCCESS )
+	{
+		// 2. Divmod fusion
+		fuse_divmod( &C );
+
+		size_t steps = 0, inputs = 0;
+		for( size_t i = 0; i < C.count; i++ )
+		{
+			if( C.v[i].kind == VALUE_INPUT )
+				inputs++;
+			else if( C.v[i].kind == VALUE_STEP && C.v[i].source == i )
+				steps++;
+		}
+
+		plan -> steps = malloc( ( steps ? steps : 1 ) * sizeof( Plan_step ) );
+		plan -> inputs = malloc( ( inputs ? inputs : 1 ) * sizeof( char * ) );
+		plan -> regs = malloc( ( C.count ? C.count : 1 ) * sizeof( Plan_register ) );
+		free_regs = malloc( ( C.count ? C.count : 1 ) * sizeof( size_t ) );
+
+		if( plan -> steps == NULL || plan -> inputs == NULL || plan -> regs == NULL || free_regs == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			status = FAILURE;
+		}
+	}
+
+	if( status == SUCCESS )
+	{
+		// Last use of every value, counted in steps
+		size_t s = 0, operands[3];
+		for( size_t i = 0; i < C.count; i++ )
+		{
+			if( C.v[i].kind != VALUE_STEP || C.v[i].source != i )
+				continue;
+
+			for( size_t k = step_operands( &C.v[i], operands ); k-- > 0; )
+			{
+				C.v[ operands[k] ].used = 1;
+				C.v[ operands[k] ].last_use = s;
+			}
+			s++;
+		}
+
+		// 3. Registers: inputs, then constants, in order of appearance
+		for( size_t i = 0; i < C.count; i++ )
+		{
+			if( C.v[i].kind == VALUE_INPUT )
+			{
+				C.v[i].reg = plan -> reg_count;
+				plan -> inputs[ plan -> input_count++ ] = C.v[i].name;
+				C.v[i].name = NULL;
+				plan -> regs[ plan -> reg_count++ ] = (Plan_register) { { NULL, 0, 0 }, '+' };
+			}
+		}
+
+		for( size_t i = 0; i < C.count; i++ )
+		{
+			if( C.v[i].kind == VALUE_CONSTANT )
+			{
+				C.v[i].reg = plan -> reg_count;
+				plan -> regs[ plan -> reg_count ] = (Plan_register) { C.v[i].num, '+' };
+				init_number( &C.v[i].num );
+				plan -> reg_count++;
+			}
+		}
+
+		// Temporaries: a result takes a free register, operands are released after their last use
+		for( size_t i = 0; i < C.count; i++ )
+		{
+			Value *v = &C.v[i];
+			if( v -> kind != VALUE_STEP || v -> source != i )
+				continue;
+
+			size_t outputs[2] = { i, i },
+				   out_count = 1;
+			if( v -> op == PLAN_DIVMOD )
+			{
+				outputs[0] = v -> quot;
+				outputs[1] = v -> rem;
+				out_count = 2;
+			}
+
+			for( size_t k = 0; k < out_count; k++ )
+			{
+				size_t reg;
+				if( free_count )
+					reg = free_regs[ --free_count ];
+				else
+				{
+					reg = plan -> reg_count++;
+					plan -> regs[ reg ] = (Plan_register) { { NULL, 0, 0 }, '+' };
+				}
+				C.v[ outputs[k] ].reg = reg;
+			}
+
+			Plan_step *step = &plan -> steps[ plan -> step_count ];
+			step -> op = v -> op;
+			step -> dst = C.v[ outputs[0] ].reg;
+			step -> dst2 = C.v[ outputs[1] ].reg;
+			step -> a = register_ref( &C, v -> a );
+			step -> b = register_ref( &C, v -> b );
+			step -> c = v -> op == PLAN_MODPOW ? register_ref( &C, v -> c ) : (Plan_ref) { 0, 0 };
+
+			// Operands read for the last time, and results nobody reads, give their registers back
+			size_t operands[3],
+				   n = step_operands( v, operands );
+			for( size_t k = 0; k < n; k++ )
+			{
+				Value *o = &C.v[ operands[k] ];
+				if( o -> kind == VALUE_STEP && o -> last_use == plan -> step_count && o -> reg != SIZE_MAX
+					&& operands[k] != result.reg )
+				{
+					free_regs[ free_count++ ] = o -> reg;
+					o -> reg = SIZE_MAX;	// Released once even when read twice by this step
+				}
+			}
+
+			for( size_t k = 0; k < out_count; k++ )
+				if( !C.v[ outputs[k] ].used && outputs[k] != result.reg )
+					free_regs[ free_count++ ] = C.v[ outputs[k] ].reg;
+
+			plan -> step_count++;
+		}
+
+		plan -> result = register_ref( &C, result );
+	}
+
+	free( free_regs );
+	free_compiler( &C );
+
+	if( status != SUCCESS )
+		plan_free( plan );
+
+	return status;
+}
+
+void plan_free( Plan *plan )
+{
+	if( plan -> regs )
+		for( size_t i = 0; i < plan -> reg_count; i++ )
+			free_number( &plan -> regs[i].num );
+
+	if( plan -> inputs )
+		for( size_t i = 0; i < plan -> input_count; i++ )
+			free( plan -> inputs[i] );
+
+	free( plan -> regs );
+	free( plan -> inputs );
+	free( plan -> steps );
+	memset( plan, 0, sizeof( Plan ) );
+}
+
+/* Sign of a register as seen through a reference */
+static char ref_sign( const Plan *plan, Plan_ref ref )
+{
+	char sign = plan -> regs[ ref.reg ].sign;
+	return ref.negate ? ( sign == '+' ? '-' : '+' ) : sign;
+}
+
+Status plan_run( Plan *plan, const Bignum **value, char *sign )
+{
+	Plan_register *R = plan -> regs;
+
+	for( size_t i = 0; i < plan -> step_count; i++ )
+	{
+		const Plan_step *S = &plan -> steps[i];
+		char s1 = ref_sign( plan, S -> a ),
+			 s2 = ref_sign( plan, S -> b );
+		Status status;
+
+		switch( S -> op )
+		{
+			case PLAN_DIVMOD:
+				// Quotient and remainder follow the sign rule of '/' and '%'
+				status = divmod( &R[ S -> a.reg ].num, &R[ S -> b.reg ].num, &R[ S -> dst ].num, &R[ S -> dst2 ].num );
+				R[ S -> dst ].sign = R[ S -> dst2 ].sign = ( s1 == s2 ) ? '+' : '-';
+				break;
+
+			case PLAN_MODPOW:
+				status = apply_operator( '^', &R[ S -> a.reg ].num, s1, &R[ S -> b.reg ].num, s2, &R[ S -> c.reg ].num,
+										 ref_sign( plan, S -> c ), &R[ S -> dst ].num, &R[ S -> dst ].sign, NULL );
+				break;
+
+			default:
+				status = apply_operator( plan_operator[ S -> op ], &R[ S -> a.reg ].num, s1, &R[ S -> b.reg ].num, s2, NULL,
+										 '+', &R[ S -> dst ].num, &R[ S -> dst ].sign, NULL );
+				break;
+		}
+
+		if( status != SUCCESS )
+			return status;
+	}
+
+	*value = &R[ plan -> result.reg ].num;
+	*sign = ref_sign( plan, plan -> result );
+
+	return SUCCESS;
+}
+
+/* Load one input line into the input registers; NON_NUMERIC for a wrong count or a bad operand */
+static Status load_inputs( Plan *plan, char *line )
+{
+	size_t count = 0;
+	char *p = line;
+
+	while( 1 )
+	{
+		while( isspace( (unsigned char) *p ) )
+			p++;
+		if( *p == '\0' )
+			break;
+
+		char *token = p;
+		while( *p && !isspace( (unsigned char) *p ) )
+			p++;
+		if( *p )
+			*p++ = '\0';
+
+		if( count == plan -> input_count || ( token[0] != '@' && isNumeric( token ) == NON_NUMERIC ) )
+			return NON_NUMERIC;
+
+		plan -> regs[ count ].sign = '+';
+		Status load = load_operand( token, &plan -> regs[ count ].num, &plan -> regs[ count ].sign );
+		if( load != SUCCESS )
+			return load;
+
+		count++;
+	}
+
+	return count == plan -> input_count ? SUCCESS : NON_NUMERIC;
+}
+
+Status run_plan( const char *expression, FILE *in, FILE *out )
+{
+	char error[ 96 ];
+	const char *rest = expression;
+
+	Expr_node *root = expr_parse( &rest, NULL, error, sizeof( error ) );
+
+	// One expression, no assignment
+	while( root && isspace( (unsigned char) *rest ) )
+		rest++;
+
+	if( root == NULL || root -> kind == EXPR_ASSIGN || *rest )
+	{
+		if( root )
+			printf("INFO : A plan is one expression without assignments\n");
+		else
+			printf( "INFO : %s\n", error[0] ? error : "Empty Expression" );
+
+		expr_free( root );
+		return FAILURE;
+	}
+
+	apc_arena_begin();
+
+	Plan plan;
+	Status status = plan_compile( root, &plan );
+	expr_free( root );
+
+	// Without variables no input line can supply a value, so there is nothing to evaluate per line
+	if( status == SUCCESS && plan.input_count == 0 )
+	{
+		printf("INFO : A plan needs at least one variable; use --expr to evaluate a constant expression\n");
+		status = FAILURE;
+	}
+
+	char *line = NULL;
+	size_t line_cap = 0;
+
+	while( status == SUCCESS && getline( &line, &line_cap, in ) != -1 )
+	{
+		char *p = line;
+		while( isspace( (unsigned char) *p ) )
+			p++;
+
+		if( *p == '\0' )
+		{
+			fputc( '\n', out );
+			continue;
+		}
+
+		const Bignum *value;
+		char sign;
+		Status calc = load_inputs( &plan, line );
+		if( calc == SUCCESS )
+			calc = plan_run( &plan, &value, &sign );
+
+		char *digits = ( calc == SUCCESS ) ? Number_to_string( value ) : NULL;
+
+		if( calc == ZERO_DIVISOR )
+			fputs( "ERROR: Division by Zero\n", out );
+		else if( calc == NON_NUMERIC )
+			fputs( "ERROR: Invalid Input\n", out );
+		else if( digits == NULL )
+			fputs( "ERROR: Calculation Failure\n", out );
+		else
+		{
+			if( sign == '-' && value -> len )
+				fputc( '-', out );
+			fputs( digits, out );
+			fputc( '\n', out );
+		}
+
+		free( digits );
+	}
+
+	if( status == SUCCESS && ( ferror( in ) || fflush( out ) == EOF ) )
+		status = FAILURE;
+
+	free( line );
+	plan_free( &plan );
+	apc_arena_end();
+
+	return status;
+}
\ No newline at end of file
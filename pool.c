@@ -0,0 +1,271 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : pool_create / pool_submit / pool_destroy
+ * Description      : Work-stealing thread pool. Every worker owns a double-ended task queue: tasks submitted from outside the
+ *                    pool are dealt round-robin over the workers' queues, tasks submitted by a worker go to its own queue. A
+ *                    worker takes its oldest task first, and once its queue is empty it steals the newest task of another
+ *                    worker, so an uneven mix of tiny and huge calculations still keeps every core busy.
+ *
+ * Prototype        : Pool *pool_create( int threads );
+ *                    Status pool_submit( Pool *pool, Task_fn fn, void *arg );
+ *                    void pool_destroy( Pool *pool );
+ *
+ * Input Parameters : threads -> Number of worker threads (at least 1).
+ *                    fn, arg -> Task function and its argument; fn( arg ) runs exactly once on some worker.
+ *
+ * Return Value     : pool_create -> The pool, NULL if threads or memory could not be obtained.
+ *                    pool_submit -> SUCCESS, or FAILURE if the queue could not grow (the task is then not run).
+ *
+ * Algorithm        :
+ *                    1. Each queue is a growable ring buffer guarded by its own mutex, so owners and thieves only contend on
+ *                       the queue they actually touch.
+ *                    2. A pool-wide count of queued tasks, guarded by the pool mutex, lets idle workers sleep on a condition
+ *                       variable instead of spinning; every submission wakes one sleeper. The count is raised before
+ *                       the task is pushed (and lowered again if the push fails), so it never drops below the tasks still
+ *                       to run; a worker that sees it before the push only looks through the queues once more.
+ *                    3. Worker loop: pop the front of its own queue → otherwise steal the back of the next non-empty queue
+ *                       → otherwise sleep until a task is queued or the pool is shut down.
+ *                    4. pool_destroy() lets the workers drain every queued task, then joins them.
+ *
+ * Notes            :
+ *                    • Tasks must report their own results; the pool only runs them.
+ *                    • Each worker thread has its own arena state (arena.c), so tasks may allocate freely.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <pthread.h>
+
+typedef struct
+{
+	Task_fn fn;
+	void *arg;
+} Task;
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	Task *items;			// Ring buffer of cap tasks
+	size_t head, count, cap;
+} Task_queue;
+
+struct Pool
+{
+	int threads;
+	pthread_t *ids;
+	Task_queue *queues;
+
+	pthread_mutex_t lock;	// Guards queued, stop and the round-robin cursor
+	pthread_cond_t wake;
+	size_t queued;			// Tasks sitting in any queue
+	int stop;
+	int next;				// Queue receiving the next outside submission
+	int started;			// Workers that have claimed their index
+};
+
+/* Worker index of the calling thread inside its pool, -1 outside a pool */
+static _Thread_local int worker_index = -1;
+static _Thread_local Pool *worker_pool;
+
+static Status queue_push( Task_queue *q, Task task )
+{
+	pthread_mutex_lock( &q -> lock );
+
+	if( q -> count == q -> cap )
+	{
+		// Double the ring and unwrap it to start at index 0
+		size_t cap = q -> cap ? 2 * q -> cap : 64;
+		Task *items = malloc( cap * sizeof( Task ) );
+		if( items == NULL )
+		{
+			pthread_mutex_unlock( &q -> lock );
+			perror("INFO : Memory Allocation Failed");
+			return FAILURE;
+		}
+
+		for( size_t i = 0; i < q -> count; i++ )
+			items[i] = q -> items[ ( q -> head + i ) % q -> cap ];
+
+		free( q -> items );
+		q -> items = items;
+		q -> head = 0;
+		q -> cap = cap;
+	}
+
+	q -> items[ ( q -> head + q -> count ) % q -> cap ] = task;
+	q -> count++;
+
+	pthread_mutex_unlock( &q -> lock );
+	return SUCCESS;
+}
+
+/* Take the oldest task (owner) or the newest task (thief) */
+static int queue_take( Task_queue *q, Task *task, int steal )
+{
+	pthread_mutex_lock( &q -> lock );
+
+	if( q -> count == 0 )
+	{
+		pthread_mutex_unlock( &q -> lock );
+		return 0;
+	}
+
+	if( steal )
+		*task = q -> items[ ( q -> head + q -> count - 1 ) % q -> cap ];
+	else
+	{
+		*task = q -> items[ q -> head ];
+		q -> head = ( q -> head + 1 ) % q -> cap;
+	}
+	q -> count--;
+
+	pthread_mutex_unlock( &q -> lock );
+	return 1;
+}
+
+static void *worker_main( void *arg )
+{
+	Pool *pool = arg;
+
+	// Workers learn their index from the order they start; the lock is free only once pool_create() has started them all
+	pthread_mutex_lock( &pool -> lock );
+	worker_index = pool -> started++;
+	pthread_mutex_unlock( &pool -> lock );
+	worker_pool = pool;
+
+	while( 1 )
+	{
+		Task task;
+		int found = queue_take( &pool -> queues[ worker_index ], &task, 0 );
+
+		// Own queue is empty: steal, starting with the neighbour
+		for( int k = 1; !found && k < pool -> threads; k++ )
+			found = queue_take( &pool -> queues[ ( worker_index + k ) % pool -> threads ], &task, 1 );
+
+		pthread_mutex_lock( &pool -> lock );
+
+		if( found )
+		{
+			pool -> queued--;
+			pthread_mutex_unlock( &pool -> lock );
+
+			task.fn( task.arg );
+			continue;
+		}
+
+		// Nothing anywhere: sleep until a submission or shutdown
+		if( pool -> queued == 0 )
+		{
+			if( pool -> stop )
+			{
+				pthread_mutex_unlock( &pool -> lock );
+				break;
+			}
+			pthread_cond_wait( &pool -> wake, &pool -> lock );
+		}
+
+		pthread_mutex_unlock( &pool -> lock );
+	}
+
+	return NULL;
+}
+
+Pool *pool_create( int threads )
+{
+	if( threads < 1 )
+		threads = 1;
+
+	Pool *pool = calloc( 1, sizeof( Pool ) );
+	if( pool == NULL || ( pool -> ids = calloc( threads, sizeof( pthread_t ) ) ) == NULL
+		|| ( pool -> queues = calloc( threads, sizeof( Task_queue ) ) ) == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		if( pool )
+			free( pool -> ids );
+		free( pool );
+		return NULL;
+	}
+
+	pool -> threads = threads;
+	pthread_mutex_init( &pool -> lock, NULL );
+	pthread_cond_init( &pool -> wake, NULL );
+	for( int i = 0; i < threads; i++ )
+		pthread_mutex_init( &pool -> queues[i].lock, NULL );
+
+	// Workers block on the pool lock before they look at anything, so they only ever see the final thread count
+	pthread_mutex_lock( &pool -> lock );
+
+	for( int i = 0; i < threads; i++ )
+	{
+		if( pthread_create( &pool -> ids[i], NULL, worker_main, pool ) != 0 )
+		{
+			perror("INFO : Thread Creation Failed");
+
+			// Keep the workers that did start, the pool just runs narrower
+			pool -> threads = i;
+			for( int j = i; j < threads; j++ )
+				pthread_mutex_destroy( &pool -> queues[j].lock );
+			break;
+		}
+	}
+
+	pthread_mutex_unlock( &pool -> lock );
+
+	if( pool -> threads == 0 )
+	{
+		pool_destroy( pool );
+		return NULL;
+	}
+
+	return pool;
+}
+
+Status pool_submit( Pool *pool, Task_fn fn, void *arg )
+{
+	Task task = { fn, arg };
+	int q;
+
+	// Counted before it is pushed, so a worker that takes it at once never drives queued below zero
+	pthread_mutex_lock( &pool -> lock );
+	if( worker_pool == pool )
+		q = worker_index;
+	else
+		q = pool -> next++ % pool -> threads;
+	pool -> queued++;
+	pthread_mutex_unlock( &pool -> lock );
+
+	Status status = queue_push( &pool -> queues[q], task );
+
+	pthread_mutex_lock( &pool -> lock );
+	if( status == SUCCESS )
+		pthread_cond_signal( &pool -> wake );
+	else
+		pool -> queued--;
+	pthread_mutex_unlock( &pool -> lock );
+
+	if( status != SUCCESS )
+		return FAILURE;
+
+	return SUCCESS;
+}
+
+void pool_destroy( Pool *pool )
+{
+	pthread_mutex_lock( &pool -> lock );
+	pool -> stop = 1;
+	pthread_cond_broadcast( &pool -> wake );
+	pthread_mutex_unlock( &pool -> lock );
+
+	for( int i = 0; i < pool -> threads; i++ )
+		pthread_join( pool -> ids[i], NULL );
+
+	for( int i = 0; i < pool -> threads; i++ )
+	{
+		pthread_mutex_destroy( &pool -> queues[i].lock );
+		free( pool -> queues[i].items );
+	}
+
+	pthread_mutex_destroy( &pool -> lock );
+	pthread_cond_destroy( &pool -> wake );
+	free( pool -> queues );
+	free( pool -> ids );
+	free( pool );
+}
\ No newline at end of file
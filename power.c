@@ -1,24 +1,24 @@
 /*******************************************************************************************************************************************************************
  * Function Name    : power
- * Description      : Computes the power of a large number (base^exponent) using repeated multiplication. Both the base and 
- *                    exponent are represented as doubly linked lists where each node stores a single digit — the head node 
- *                    represents the Most Significant Digit (MSD) and the tail node represents the Least Significant Digit (LSD). 
- *                    The result is initialized to 1 and multiplied repeatedly by the base until the exponent becomes zero.
+ * Description      : Computes the power of a large number (base^exponent) using left-to-right sliding-window exponentiation.
+ *                    Both the base and exponent are represented as packed limb arrays where each limb stores a base 2^32 
+ *                    digit — index 0 holds the Least Significant Limb. The exponent is scanned bit by bit from the top: every
+ *                    bit squares the result, and every window of up to k bits ending in a 1 multiplies it by a precomputed
+ *                    odd power of the base.
  *
- * Prototype        : Status power( Dlist **baseH, Dlist **baseT,
- *                                  Dlist **expH,  Dlist **expT,
- *                                  Dlist **headR, Dlist **tailR );
+ * Prototype        : Status power( const Bignum *base, const Bignum *exp, Bignum *result );
  *
- * Input Parameters : baseH, baseT -> Pointers to the head and tail of the base number list.
- *                    expH,  expT  -> Pointers to the head and tail of the exponent number list.
- *                    headR, tailR -> Pointers to the head and tail of the result number list (initially empty).
+ * Input Parameters : base   -> Base number.
+ *                    exp    -> Exponent number.
+ *                    result -> Number receiving base^exp (must not alias base or exp).
  *
  * Return Value     : SUCCESS -> If power computation completes successfully.
- *                    FAILURE -> If multiplication or node insertion fails due to memory allocation error.
+ *                    FAILURE -> If multiplication or limb allocation fails due to memory allocation error.
  *
  * Special Cases    :
  *                    • If exponent = 0 → Result = 1 (by mathematical definition).
  *                    • If base = 0 and exponent = 0 → Result = 1 (consistent with most programming conventions).
+ *                    • If base = 0 or 1 (exponent > 0) → Result = base, without scanning the exponent.
  *                    • Handles very large base and exponent values that exceed standard data types.
  *
  * Sign Handling (Managed Externally):
@@ -31,116 +31,155 @@
  * Algorithm        :
  *                    1. Initialize result = 1.
  *                    2. If exponent = 0 → return result as 1.
- *                    3. While exponent > 0:
- *                         a. Copy current result into a temporary list.
- *                         b. Clear the original result list.
- *                         c. Multiply temporary list with the base list.
- *                         d. Decrement exponent by one using subtract_one().
- *                    4. Remove any leading zeros from the result list.
+ *                    3. Pick the window size k from the exponent's bit length and precompute the odd powers
+ *                       base^1, base^3, ..., base^(2^k - 1).
+ *                    4. Scan the exponent from its top bit:
+ *                         a. A 0 bit squares the result.
+ *                         b. A 1 bit opens a window of up to k bits, shortened so it also ends in a 1; the result is
+ *                            squared once per window bit and multiplied by the table entry for the window value.
+ *                    5. Every product goes into one temporary number that is swapped with the result, so both buffers
+ *                       are reused for the whole computation instead of being copied and freed each step.
  *
  * Notes            :
- *                    • Implements repeated multiplication (O(exponent × base_length)) — suitable for moderate exponents.
- *                    • Exponentiation-by-squaring can replace this method for optimization (future enhancement).
+ *                    • Needs about log2(exponent) squarings plus log2(exponent) / (k + 1) multiplications, instead of
+ *                      exponent multiplications for repeated multiplication.
+ *                    • Squarings pass the same number twice to multiplication(), which lets the NTT transform only once.
  *                    • Works purely on magnitudes; sign and display are handled externally by the main driver.
  *******************************************************************************************************************************************************************
  * Helper Functions :
- *                    1. subtract_one() → Decrements a number (in Dlist form) by one, managing borrow propagation.
- *                    2. copy_list()    → Creates a duplicate of a given doubly linked list (digit-by-digit copy).
- *                    3. free_list()    → Frees all nodes in a given doubly linked list and resets head and tail to NULL.
+ *                    1. subtract_one()  → Decrements a number by one, managing borrow propagation.
+ *                    2. exp_bit()       → Reads one bit of the exponent.
+ *                    3. window_power()  → The sliding-window scan itself, parameterised by the product so that mod_power()
+ *                                         (modpow.c) reuses it with Montgomery / Barrett modular products.
+ *                    4. copy_number()   → Creates a duplicate of a given number (Common.c).
+ *                    5. free_number()   → Frees the limb array of a number and resets it to zero (Common.c).
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
 
+#define MAX_WINDOW 5
 
-Status power ( Dlist **baseH, Dlist **baseT, Dlist **expH, Dlist **expT, Dlist **headR, Dlist **tailR )
+/* Bit i of a number (bit 0 is the least significant) */
+static int exp_bit( const Bignum *exp, size_t i )
 {
-    *headR = NULL;
-    *tailR = NULL;
-    
-    // Initialise result as 1
-    insert_at_first( headR, tailR, 1 );
-
-    // Case: Exponent is zero
-    if( (*expH) -> data == 0 && (*expH) -> next == NULL )
-        return SUCCESS;         // Already result is initialised with 1
-
-    // Run loop until exponent reaches zero
-    while( (*expH) -> data || (*expH) -> next )
-    {
-        // Res_Copy is copy of the result that will be multiplied with the base
-        Dlist* Res_copyH = NULL, *Res_copyT = NULL;
-        copy_list( *headR, *tailR, &Res_copyH, &Res_copyT );
+    return ( exp -> limbs[ i / LIMB_BITS ] >> ( i % LIMB_BITS ) ) & 1;
+}
 
-        // Free the result list inorder to
-        free_list( headR, tailR );
+/* Plain product for window_power() */
+static Status plain_multiply( const Bignum *num1, const Bignum *num2, Bignum *result, void *ctx )
+{
+    (void) ctx;
+    return multiplication( num1, num2, result );
+}
 
-        // Product = Product * base
-        if( multiplication( &Res_copyH, &Res_copyT, baseH, baseT, headR, tailR ) == FAILURE )
-            return FAILURE;
+Status power ( const Bignum *base, const Bignum *exp, Bignum *result )
+{
+    STAT_SCOPE( STAT_POWER );
 
-        // Exponent--
-        subtract_one( expH, expT );
+    // Initialise result as 1
+    if( set_number_word( result, 1 ) != SUCCESS )
+        return FAILURE;
 
-    }
+    // Case: Exponent is zero
+    if( exp -> len == 0 )
+        return SUCCESS;         // Already result is initialised with 1
 
-    // Remove leading zeroes from result
-	while( (*headR) -> next && (*headR) -> data == 0 )
-        delete_at_first( headR, tailR );
+    // Case: Base is zero or one, every power is the base itself
+    if( base -> len == 0 || ( base -> len == 1 && base -> limbs[0] == 1 ) )
+        return copy_number( base, result );
 
-    return SUCCESS;
+    return window_power( base, exp, result, plain_multiply, NULL );
 
 }
 
-
-void subtract_one( Dlist **head, Dlist **tail )
+/* Sliding-window scan shared by power() and mod_power(): result = base^exp (exp > 0) under the given product */
+Status window_power( const Bignum *base, const Bignum *exp, Bignum *result, Multiply_fn multiply, void *ctx )
 {
-    Dlist *temp = *tail;
-
-    while ( temp )
+    // Number of exponent bits
+    size_t bits = ( exp -> len - 1 ) * LIMB_BITS;
+    for( limb_t top = exp -> limbs[ exp -> len - 1 ]; top; top >>= 1 )
+        bits++;
+
+    // Larger exponents amortise a larger table of odd powers
+    int k = bits <= 8 ? 1 : bits <= 24 ? 2 : bits <= 80 ? 3 : bits <= 240 ? 4 : MAX_WINDOW;
+    size_t entries = (size_t) 1 << ( k - 1 );
+
+    Bignum table[ 1 << ( MAX_WINDOW - 1 ) ], temp;
+    for( size_t t = 0; t < entries; t++ )
+        init_number( &table[t] );
+    init_number( &temp );
+
+    // table[t] = base^(2t + 1)
+    Status status = copy_number( base, &table[0] );
+    if( status == SUCCESS && entries > 1 )
+        status = multiply( base, base, &temp, ctx );
+    for( size_t t = 1; status == SUCCESS && t < entries; t++ )
+        status = multiply( &table[t - 1], &temp, &table[t], ctx );
+
+    int first = 1;
+    size_t i = bits;
+
+    // Run loop until all exponent bits are consumed
+    while( status == SUCCESS && i > 0 )
     {
-        if (temp -> data > 0)
+        // Zero bit: Product = Product^2
+        if( !exp_bit( exp, i - 1 ) )
         {
-            temp -> data -= 1;
-            break;
+            if( ( status = multiply( result, result, &temp, ctx ) ) == SUCCESS )
+                Swap_numbers( result, &temp );
+            i--;
+            continue;
+        }
+
+        // Window [low, i) of at most k bits that ends in a one bit
+        size_t low = i >= (size_t) k ? i - k : 0;
+        while( !exp_bit( exp, low ) )
+            low++;
+
+        size_t value = 0;
+        for( size_t b = i; b-- > low; )
+            value = ( value << 1 ) | exp_bit( exp, b );
+
+        // Leading window: result is still 1, so it simply becomes the table entry
+        if( first )
+        {
+            status = copy_number( &table[ value >> 1 ], result );
+            first = 0;
         }
         else
         {
-            temp -> data = 9;
-            temp = temp -> prev;
+            // Product = Product^(2^window) * base^value
+            for( size_t b = low; status == SUCCESS && b < i; b++ )
+            {
+                if( ( status = multiply( result, result, &temp, ctx ) ) == SUCCESS )
+                    Swap_numbers( result, &temp );
+            }
+
+            if( status == SUCCESS && ( status = multiply( result, &table[ value >> 1 ], &temp, ctx ) ) == SUCCESS )
+                Swap_numbers( result, &temp );
         }
-    }
-
-    // Remove leading zeroes from result
-	while( (*head) -> next && (*head) -> data == 0 )
-        delete_at_first( head, tail );
-        
-}
 
+        i = low;
+    }
 
-void copy_list( Dlist *srcH, Dlist *srcT, Dlist **dstH, Dlist **dstT )
-{
-    *dstH = *dstT = NULL;
+    for( size_t t = 0; t < entries; t++ )
+        free_number( &table[t] );
+    free_number( &temp );
 
-    while ( srcH )
-    {
-        insert_at_last( dstH, dstT, srcH -> data );
-        srcH = srcH -> next;
-    }
+    return status;
 }
 
-void free_list( Dlist **head, Dlist **tail )
-{
-    if( head == NULL || *head == NULL ) 
-        return;
-    
-    Dlist *cur = *head, *next;
 
-    while( cur )
+void subtract_one( Bignum *num )
+{
+    for( size_t i = 0; i < num -> len; i++ )
     {
-        next = cur -> next;
-        free( cur );
-        cur = next;
+        // Borrow stops at the first non-zero limb
+        if( num -> limbs[i]-- != 0 )
+            break;
     }
 
-    *head = *tail = NULL;
+    // Remove leading zeroes from result
+    trim_number( num );
+        
 }
\ No newline at end of file
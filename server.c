@@ -0,0 +1,253 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : run_server
+ * Description      : Persistent server mode. Listens on a Unix domain socket and serves every connection with the batch line
+ *                    protocol: the client writes calculations one per line, in the command-line layout, and reads one
+ *                    result line per calculation, in order. Connections are handed to a work-stealing thread pool (pool.c),
+ *                    and each one keeps its numbers and its arena for its whole lifetime, so a request costs a parse and
+ *                    a few limb operations instead of a fork and an exec.
+ *
+ * Prototype        : Status run_server( const char *path, int threads );
+ *
+ * Input Parameters : path    -> File system path of the socket; a stale socket left there by an earlier server is replaced.
+ *                    threads -> Worker threads, which is also the number of connections served at the same time.
+ *
+ * Return Value     : SUCCESS -> The server was stopped by SIGINT or SIGTERM.
+ *                    FAILURE -> The socket could not be set up, or accepting connections failed.
+ *
+ * Protocol         :
+ *                    • Request  → "<number1> <operator> <number2>\n" or "<base> ^ <exponent> % <modulus>\n".
+ *                    • Response → Plain signed decimal or "ERROR: ..." line, exactly as in batch mode ("@path" operands
+ *                                 are invalid input).
+ *                    • Pipelining is allowed: a client may send many lines before reading, and they are answered in order.
+ *
+ * Algorithm        :
+ *                    1. Bind and listen on the socket, install handlers for SIGINT / SIGTERM, ignore SIGPIPE.
+ *                    2. Accept loop: SIGINT / SIGTERM stay blocked except while ppoll() waits for a connection, so a stop
+ *                       request can never slip in between the check and the wait. Once the socket is readable, each
+ *                       connection is recorded in the open-connection list and submitted to the pool, where run_batch_fd()
+ *                       answers its lines until the client closes its end.
+ *                    3. On a signal: stop accepting, remove the socket file, shut down the reading side of every open
+ *                       connection so its worker finishes the answers it owes, then let the pool drain.
+ *
+ * Access Model     :
+ *                    • The socket file is created with mode 0600, so only the user running the server (and root) can
+ *                      connect; there is no further authentication. To share the server, place the socket in a directory
+ *                      whose permissions admit exactly the intended users, and change its mode after startup.
+ *                    • Clients can only submit calculations: they cannot name files ("@path" is refused), and each
+ *                      connection is bounded in line length and idle time.
+ *
+ * Notes            :
+ *                    • A connection occupies one worker while it is open; further connections wait in the pool's queue,
+ *                      so give -j at least the number of connections a client keeps open at once. A connection that
+ *                      sends nothing (or reads nothing) for SERVER_IDLE_SECONDS is closed, so idle clients cannot hold
+ *                      every worker for long.
+ *                    • A line longer than SERVER_MAX_LINE bytes is answered with "ERROR: Line Too Long" and the connection
+ *                      is closed, so one client cannot make the server buffer unlimited input.
+ *                    • A client that disconnects early only ends its own connection (SIGPIPE is ignored).
+ *                    • "@path" operands are answered with "ERROR: Invalid Input": a client never makes the server open,
+ *                      map or block on a file.
+ *******************************************************************************************************************************************************************/
+
+#define _GNU_SOURCE
+#include "apc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+/* Longest request line, and seconds a connection may wait on a read or a write before it is closed */
+#define SERVER_MAX_LINE     ( (size_t) 64 << 20 )
+#define SERVER_IDLE_SECONDS 60
+
+typedef struct Connection
+{
+	int fd;
+	struct Connection *prev, *next;
+} Connection;
+
+/* Open connections, so a stopping server can end them */
+static pthread_mutex_t connections_lock = PTHREAD_MUTEX_INITIALIZER;
+static Connection *connections;
+
+static volatile sig_atomic_t stop_server;
+
+static void on_stop_signal( int signo )
+{
+	(void) signo;
+	stop_server = 1;
+}
+
+/* Worker side: answer one connection until its client closes it */
+static void serve_connection( void *arg )
+{
+	Connection *c = arg;
+
+	// An idle or stalled client gives its worker back after SERVER_IDLE_SECONDS: the timed out read or write ends it
+	struct timeval idle = { .tv_sec = SERVER_IDLE_SECONDS };
+	setsockopt( c -> fd, SOL_SOCKET, SO_RCVTIMEO, &idle, sizeof( idle ) );
+	setsockopt( c -> fd, SOL_SOCKET, SO_SNDTIMEO, &idle, sizeof( idle ) );
+
+	// Clients are not trusted with the server's files: "@path" operands are refused
+	run_batch_fd( c -> fd, c -> fd, 0, SERVER_MAX_LINE );
+
+	pthread_mutex_lock( &connections_lock );
+	if( c -> prev )
+		c -> prev -> next = c -> next;
+	else
+		connections = c -> next;
+	if( c -> next )
+		c -> next -> prev = c -> prev;
+	pthread_mutex_unlock( &connections_lock );
+
+	close( c -> fd );
+	free( c );
+}
+
+Status run_server( const char *path, int threads )
+{
+	struct sockaddr_un addr = { .sun_family = AF_UNIX };
+	if( strlen( path ) >= sizeof( addr.sun_path ) )
+	{
+		printf("INFO : Socket path is too long\n");
+		return FAILURE;
+	}
+	strcpy( addr.sun_path, path );
+
+	// 1. Signals: the handler only sets stop_server, which the accept loop checks after every wait
+	struct sigaction sa = { 0 };
+	sa.sa_handler = on_stop_signal;
+	sigemptyset( &sa.sa_mask );
+	sigaction( SIGINT, &sa, NULL );
+	sigaction( SIGTERM, &sa, NULL );
+	signal( SIGPIPE, SIG_IGN );
+
+	int listen_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+	if( listen_fd < 0 )
+	{
+		perror("INFO : Cannot create socket");
+		return FAILURE;
+	}
+
+	// Only a socket is ever replaced, never a regular file that happens to have the name
+	struct stat st;
+	if( lstat( path, &st ) == 0 && S_ISSOCK( st.st_mode ) )
+		unlink( path );
+
+	// The socket file is created owner-only (0600): only the server's user can connect. umask() is process-wide, but
+	// no other thread exists yet.
+	mode_t old_umask = umask( 0177 );
+	int bound = bind( listen_fd, (struct sockaddr *) &addr, sizeof( addr ) );
+	umask( old_umask );
+
+	if( bound != 0 || chmod( path, 0600 ) != 0 || listen( listen_fd, SOMAXCONN ) != 0 )
+	{
+		perror("INFO : Cannot listen on socket");
+		close( listen_fd );
+		if( bound == 0 )
+			unlink( path );
+		return FAILURE;
+	}
+
+	// The stop signals stay blocked, except inside ppoll(): a signal arriving between the stop_server check and the wait
+	// is delivered when ppoll() unblocks it, and ends the wait at once. Workers inherit the blocked mask.
+	sigset_t stop_signals, old_mask, wait_mask;
+	sigemptyset( &stop_signals );
+	sigaddset( &stop_signals, SIGINT );
+	sigaddset( &stop_signals, SIGTERM );
+	pthread_sigmask( SIG_BLOCK, &stop_signals, &old_mask );
+
+	wait_mask = old_mask;
+	sigdelset( &wait_mask, SIGINT );
+	sigdelset( &wait_mask, SIGTERM );
+
+	// Only accept() once poll reports a connection; non-blocking, so a connection reset in between cannot block it
+	fcntl( listen_fd, F_SETFL, fcntl( listen_fd, F_GETFL ) | O_NONBLOCK );
+
+	Pool *pool = pool_create( threads );
+	if( pool == NULL )
+	{
+		pthread_sigmask( SIG_SETMASK, &old_mask, NULL );
+		close( listen_fd );
+		unlink( path );
+		return FAILURE;
+	}
+
+	printf( "INFO : Listening on %s\n", path );
+	fflush( stdout );
+
+	// 2. Accept loop
+	Status status = SUCCESS;
+
+	while( !stop_server )
+	{
+		struct pollfd pfd = { .fd = listen_fd, .events = POLLIN };
+		int ready = ppoll( &pfd, 1, NULL, &wait_mask );
+		if( ready < 0 && errno != EINTR )
+		{
+			perror("INFO : Cannot wait for connections");
+			status = FAILURE;
+			break;
+		}
+		if( ready <= 0 )
+			continue;
+
+		int fd = accept( listen_fd, NULL, NULL );
+		if( fd < 0 )
+		{
+			if( errno == EINTR || errno == ECONNABORTED || errno == EAGAIN || errno == EWOULDBLOCK )
+				continue;
+
+			// Out of descriptors: existing connections keep running, retry after they had a moment to close
+			if( errno == EMFILE || errno == ENFILE )
+			{
+				usleep( 10000 );
+				continue;
+			}
+
+			perror("INFO : Cannot accept connection");
+			status = FAILURE;
+			break;
+		}
+
+		Connection *c = malloc( sizeof( Connection ) );
+		if( c == NULL )
+		{
+			perror("INFO : Memory Allocation Failed");
+			close( fd );
+			continue;
+		}
+
+		c -> fd = fd;
+		c -> prev = NULL;
+
+		pthread_mutex_lock( &connections_lock );
+		c -> next = connections;
+		if( connections )
+			connections -> prev = c;
+		connections = c;
+		pthread_mutex_unlock( &connections_lock );
+
+		if( pool_submit( pool, serve_connection, c ) != SUCCESS )
+			serve_connection( c );
+	}
+
+	// 3. Stop: no new connections, open ones see end of input once their pending lines are answered
+	close( listen_fd );
+	unlink( path );
+
+	pthread_mutex_lock( &connections_lock );
+	for( Connection *c = connections; c; c = c -> next )
+		shutdown( c -> fd, SHUT_RD );
+	pthread_mutex_unlock( &connections_lock );
+
+	pool_destroy( pool );
+	pthread_sigmask( SIG_SETMASK, &old_mask, NULL );
+
+	return status;
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : stats_enter / stats_leave / stats_alloc / stats_free / stats_realloc / stats_dump
+ * Description      : Optional instrumentation of the arithmetic hot paths. Built with -DAPC_STATS (make stats → apc_stats.out),
+ *                    every instrumented function counts its calls and its wall time, and the arena counts the blocks and
+ *                    bytes it hands out together with the peak of live memory. --stats dumps the totals as JSON to stderr
+ *                    when the program exits. In the normal build the hooks are empty macros, so they cost nothing.
+ *
+ * Prototype        : Stat_scope stats_enter( Stat_id id );
+ *                    void stats_leave( Stat_scope *scope );
+ *                    void stats_alloc( size_t bytes, int system );
+ *                    void stats_free( size_t bytes, size_t blocks );
+ *                    void stats_realloc( size_t old_bytes, size_t new_bytes );
+ *                    Status stats_dump( FILE *out );
+ *
+ * Input Parameters : id     -> Operation entered by the calling function.
+ *                    scope  -> Operation and start time, filled by STAT_SCOPE() and recorded when it goes out of scope.
+ *                    bytes  -> Usable bytes of a block handed out or released.
+ *                    system -> Non-zero when the block cost a malloc() call (arena chunk or large block).
+ *                    blocks -> Blocks released, 0 when a closing arena drops its remaining blocks in bulk.
+ *                    old_bytes, new_bytes -> Block size before and after an apc_realloc() call.
+ *                    out    -> Stream receiving the JSON document.
+ *
+ * Return Value     : stats_dump -> SUCCESS, or FAILURE when the program was built without APC_STATS.
+ *
+ * Output Format    :
+ *                    { "operations": { "<name>": { "calls": c, "ns": t }, ... },
+ *                      "memory": { "allocations", "reallocations", "frees", "bytes_allocated", "system_allocations",
+ *                                  "live_bytes", "peak_live_bytes", "peak_live_limbs" } }
+ *
+ * Notes            :
+ *                    • STAT_SCOPE( id ) at the top of a function records on every return path (GCC cleanup attribute).
+ *                    • Times are inclusive: Karatsuba's time contains its schoolbook products, multiplication() contains
+ *                      the kernel it picked. A recursive call counts as a call but is timed only at its outermost level.
+ *                    • Operations with no calls are listed too, so the schema never changes.
+ *                    • Counters are relaxed atomics, so the totals of parallel batch and multiplication threads add up.
+ *                    • Live memory counts blocks handed out by the arena (limb arrays and scratch); blocks still live when
+ *                      an arena closes are released with it.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+#ifdef APC_STATS
+
+#include <stdatomic.h>
+#include <time.h>
+
+static const char *stat_names[ STAT_COUNT ] =
+{
+	"addition", "subtraction", "add_to", "sub_from",
+	"multiplication", "mul_basecase", "mul_karatsuba", "mul_toom3", "mul_ntt", "mul_add", "mul_small",
+	"division", "divmod", "div_word", "div_word_preinv", "div_knuth", "div_newton", "reciprocal_init", "reciprocal_divide",
+	"power", "mod_power", "decimal_to_number", "number_to_decimal", "load_operand"
+};
+
+static _Atomic uint64_t calls[ STAT_COUNT ], nanoseconds[ STAT_COUNT ];
+
+static _Atomic uint64_t allocations, reallocations, frees, bytes_allocated, system_allocations;
+static _Atomic int64_t live_bytes, peak_live_bytes;
+
+/* Open calls per operation on this thread, so recursive kernels are timed once at their outermost level */
+static _Thread_local unsigned depth[ STAT_COUNT ];
+
+Stat_scope stats_enter( Stat_id id )
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	depth[ id ]++;
+	return (Stat_scope) { id, (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec };
+}
+
+void stats_leave( Stat_scope *scope )
+{
+	atomic_fetch_add_explicit( &calls[ scope -> id ], 1, memory_order_relaxed );
+
+	if( --depth[ scope -> id ] > 0 )
+		return;
+
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	uint64_t now = (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+	atomic_fetch_add_explicit( &nanoseconds[ scope -> id ], now - scope -> start, memory_order_relaxed );
+}
+
+/* Moves the live byte count and raises the peak unless another thread already raised it further */
+static void add_live( int64_t delta )
+{
+	int64_t live = atomic_fetch_add_explicit( &live_bytes, delta, memory_order_relaxed ) + delta,
+			peak = atomic_load_explicit( &peak_live_bytes, memory_order_relaxed );
+
+	while( live > peak && !atomic_compare_exchange_weak_explicit( &peak_live_bytes, &peak, live, memory_order_relaxed,
+																  memory_order_relaxed ) )
+		;
+}
+
+void stats_alloc( size_t bytes, int system )
+{
+	atomic_fetch_add_explicit( &allocations, 1, memory_order_relaxed );
+	atomic_fetch_add_explicit( &bytes_allocated, bytes, memory_order_relaxed );
+	if( system )
+		atomic_fetch_add_explicit( &system_allocations, 1, memory_order_relaxed );
+
+	add_live( (int64_t) bytes );
+}
+
+void stats_free( size_t bytes, size_t blocks )
+{
+	atomic_fetch_add_explicit( &frees, blocks, memory_order_relaxed );
+	add_live( -(int64_t) bytes );
+}
+
+void stats_realloc( size_t old_bytes, size_t new_bytes )
+{
+	atomic_fetch_add_explicit( &reallocations, 1, memory_order_relaxed );
+	if( new_bytes > old_bytes )
+		atomic_fetch_add_explicit( &bytes_allocated, new_bytes - old_bytes, memory_order_relaxed );
+
+	add_live( (int64_t) new_bytes - (int64_t) old_bytes );
+}
+
+Status stats_dump( FILE *out )
+{
+	fprintf( out, "{\n  \"operations\": {\n" );
+
+	for( int i = 0; i < STAT_COUNT; i++ )
+		fprintf( out, "    \"%s\": { \"calls\": %llu, \"ns\": %llu }%s\n", stat_names[i],
+				 (unsigned long long) atomic_load( &calls[i] ), (unsigned long long) atomic_load( &nanoseconds[i] ),
+				 i + 1 < STAT_COUNT ? "," : "" );
+
+	int64_t peak = atomic_load( &peak_live_bytes );
+
+	fprintf( out, "  },\n  \"memory\": {\n"
+				  "    \"allocations\": %llu,\n    \"reallocations\": %llu,\n    \"frees\": %llu,\n"
+				  "    \"bytes_allocated\": %llu,\n    \"system_allocations\": %llu,\n"
+				  "    \"live_bytes\": %lld,\n    \"peak_live_bytes\": %lld,\n    \"peak_live_limbs\": %lld\n  }\n}\n",
+			 (unsigned long long) atomic_load( &allocations ), (unsigned long long) atomic_load( &reallocations ),
+			 (unsigned long long) atomic_load( &frees ), (unsigned long long) atomic_load( &bytes_allocated ),
+			 (unsigned long long) atomic_load( &system_allocations ), (long long) atomic_load( &live_bytes ),
+			 (long long) peak, (long long) ( peak / (int64_t) sizeof( limb_t ) ) );
+
+	return SUCCESS;
+}
+
+#else
+
+Status stats_dump( FILE *out )
+{
+	(void) out;
+	return FAILURE;
+}
+
+#endif
\ No newline at end of file
@@ -1,20 +1,21 @@
 /*******************************************************************************************************************************************************************
  * Function Name    : subtraction
- * Description      : Performs subtraction of two large positive numbers stored in doubly linked lists. The digits are stored
- *                    such that the head represents the Most Significant Digit (MSB) and the tail represents the Least Significant Digit (LSB).
- *                    This function assumes that the caller (typically main) has already determined which number is larger and handled any
- *                    sign management or operand swapping before the call.
+ * Description      : Performs subtraction of two large positive numbers stored in packed limb arrays. The limbs are stored
+ *                    such that index 0 holds the Least Significant Limb and index len - 1 holds the Most Significant Limb.
+ *                    This function assumes that the caller (apply_operator() in calculate.c) has already determined which number is
+ *                    larger and handled the sign and the operand order before the call.
  *
- * Prototype        : Status subtraction( Dlist **head1, Dlist **tail1,
- *                                       Dlist **head2, Dlist **tail2,
- *                                       Dlist **headR, Dlist **tailR );
+ * Prototype        : Status subtraction( const Bignum *num1, const Bignum *num2, Bignum *result );
+ *                    Status sub_from( Bignum *acc, const Bignum *num );
  *
- * Input Parameters : head1, tail1 -> Pointers to the head and tail of the first (larger) number list.
- *                    head2, tail2 -> Pointers to the head and tail of the second (smaller) number list.
- *                    headR, tailR -> Pointers to the head and tail of the result number list (initially empty).
+ * Input Parameters : num1   -> First (larger) number.
+ *                    num2   -> Second (smaller) number.
+ *                    result -> Number receiving the difference (must not alias num1 or num2).
+ *                    acc    -> sub_from(): accumulator updated in place, acc -= num (acc must be at least num).
  *
  * Return Value     : SUCCESS -> If subtraction is carried out successfully.
- *                    FAILURE -> If memory allocation fails during node insertion.
+ *                    FAILURE -> If memory allocation fails while growing the result (sub_from(): if num > acc, which
+ *                               leaves acc holding the wrapped-around difference).
  *
  * Special Cases    :
  *                    • If both numbers are equal → Result is 0.
@@ -23,91 +24,133 @@
  * Algorithm        :
  *                    1. Compare both numbers to detect equality.
  *                    2. If equal, result = 0.
- *                    3. Otherwise, traverse from the tail (LSB) of both lists and subtract digit-by-digit.
- *                    4. Handle borrow propagation whenever a digit underflows.
- *                    5. Insert each difference digit at the head of the result list.
- *                    6. Remove any leading zeros from the final result.
+ *                    3. Otherwise, walk both limb arrays from index 0 (LSB) and subtract limb-by-limb (sub_limbs() kernel).
+ *                    4. Handle borrow propagation whenever a limb underflows.
+ *                    5. Store each difference limb at the same index of the result.
+ *                    6. Remove any leading zero limbs from the final result.
  *
  * Notes            :
  *                    • This function does not handle sign determination; that logic must be done by the caller.
- *                    • If required, uses Swap_lists() externally before calling subtraction().
+ *                    • Operand order is the caller's job too: apply_operator() swaps its operand pointers (Swap_operands(),
+ *                      no limbs are copied) so that num1 is the larger magnitude.
+ *                    • On little-endian hosts sub_limbs() subtracts two limbs as one 64-bit word per subtract-with-borrow
+ *                      (_subborrow_u64 on x86-64); big-endian hosts take the limb-by-limb loop. It stops walking the
+ *                      longer operand once the borrow is absorbed, so sub_from() on a long accumulator only costs the
+ *                      length of the number taken off.
  *******************************************************************************************************************************************************************/
 
 #include "apc.h"
 
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#include <x86intrin.h>
+#endif
 
-Status subtraction( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR )
+/* x - y - borrow on 64-bit words, returns the borrow out (one SBB on x86-64) */
+static inline unsigned char sub_borrow_64( unsigned char borrow, uint64_t x, uint64_t y, uint64_t *diff )
 {
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+	unsigned long long d;
+	borrow = _subborrow_u64( borrow, x, y, &d );
+	*diff = d;
+	return borrow;
+#else
+	uint64_t t = x - y;
+	*diff = t - borrow;
+	return (unsigned char) ( ( x < y ) | ( t < borrow ) );
+#endif
+}
+
+
+Status subtraction( const Bignum *num1, const Bignum *num2, Bignum *result )
+{
+	STAT_SCOPE( STAT_SUBTRACTION );
 
 	// Compare and find the larger number
-	Status larger = Find_largest( *head1, *head2 );
-	int	diff = 0,
-		borrow = 0;
+	Status larger = Find_largest( num1, num2 );
 
 	// Numbers are equal, so result will be zero
 	if( larger == EQUAL )
 	{
-		insert_at_first( headR, tailR, 0 );
+		result -> len = 0;
 		return SUCCESS;
 	}
 
 	// Subtraction Logic
-	Dlist *digits_1 = *tail1;
-	Dlist *digits_2 = *tail2;
+	if( reserve_number( result, num1 -> len ) != SUCCESS )
+		return FAILURE;
 
-	while( digits_1 || digits_2 )
-	{
-		// Get each digits to subtract
-		int d1 = 0;
-		if ( digits_1 )
-		{
-			d1 = digits_1 -> data;
-			digits_1 = digits_1 -> prev;
-		}
-
-		int d2 = 0;
-		if ( digits_2 )
-		{
-			d2 = digits_2 -> data;
-			digits_2 = digits_2 -> prev;
-		}
-
-		// Subtract the borrow from previous calculation
-		d1 -= borrow;
-
-		// Update Borrow based on digits value
-		if( d1 < d2)
-		{
-			borrow = 1; 
-			d1 += 10;
-		}
-		else
-			borrow = 0;
-
-		// Calculate the difference	
-		diff = d1 - d2;
-
-		if( insert_at_first( headR, tailR, diff ) == FAILURE )
-			return FAILURE;
+	sub_limbs( result -> limbs, num1 -> limbs, num1 -> len, num2 -> limbs, num2 -> len );
 
-	}
+	result -> len = num1 -> len;
 
 	// Remove leading zeroes from result
-	while( (*headR)->next && (*headR)->data == 0 )
-        delete_at_first( headR, tailR );
+	trim_number( result );
 
 	return SUCCESS;
 }
 
-// Swap two lists for magnitude comparison
-void Swap_lists( Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2 )
+/* Limb kernel: r[0..an) = a - b for an >= bn, returns the borrow out. r may alias a or b. */
+limb_t sub_limbs( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	unsigned char borrow = 0;
+	size_t i = 0;
+
+#if LIMB_PAIR_WORDS
+	// Four limbs per step as two 64-bit words (little-endian hosts only), one subtract-with-borrow each
+	for( ; i + 4 <= bn; i += 4 )
+	{
+		uint64_t x[2], y[2], d[2];
+		memcpy( x, a + i, sizeof( x ) );
+		memcpy( y, b + i, sizeof( y ) );
+
+		borrow = sub_borrow_64( borrow, x[0], y[0], &d[0] );
+		borrow = sub_borrow_64( borrow, x[1], y[1], &d[1] );
+
+		memcpy( r + i, d, sizeof( d ) );
+	}
+#endif
+
+	for( ; i < bn; i++ )
+	{
+		// Subtract the borrow from previous calculation, wrap-around sets the next borrow
+		dlimb_t diff = (dlimb_t) a[i] - b[i] - borrow;
+		r[i] = (limb_t) diff;
+		borrow = (unsigned char) ( diff >> LIMB_BITS ) & 1;
+	}
+
+	// Propagate the borrow through the rest of the larger number; once it stops, the rest is a plain copy
+	for( ; i < an && borrow; i++ )
+	{
+		r[i] = a[i] - 1;
+		borrow = ( r[i] == (limb_t) -1 );
+	}
+
+	if( r != a && i < an )
+		memcpy( r + i, a + i, ( an - i ) * sizeof( limb_t ) );
+
+	return borrow;
+}
+
+/* In place: acc = acc - num for acc >= num, without a separate result number */
+Status sub_from( Bignum *acc, const Bignum *num )
+{
+	STAT_SCOPE( STAT_SUB_FROM );
+
+	if( acc -> len < num -> len )
+		return FAILURE;
+
+	limb_t borrow = sub_limbs( acc -> limbs, acc -> limbs, acc -> len, num -> limbs, num -> len );
+	trim_number( acc );
+
+	return borrow ? FAILURE : SUCCESS;
+}
+
+// Swap two numbers for magnitude comparison
+void Swap_numbers( Bignum *num1, Bignum *num2 )
 {
-	Dlist *tempH = *head1, *tempT = *tail1;
+	Bignum temp = *num1;
 
-	*head1 = *head2;
-	*tail1 = *tail2;
-	
-	*head2 = tempH;
-	*tail2 = tempT;
+	*num1 = *num2;
+	*num2 = temp;
 
 }
\ No newline at end of file
@@ -0,0 +1,203 @@
+/*******************************************************************************************************************************************************************
+ * Function Name    : mul_toom3
+ * Description      : Multiplies two limb arrays with the Toom-3 (Toom-Cook 3-way) algorithm. Each operand is split into three
+ *                    k-limb pieces and read as a polynomial of degree two in B^k. Both polynomials are evaluated at the points
+ *                    0, 1, -1, 2 and infinity, the five point values are multiplied recursively through mul_limbs(), and the
+ *                    product polynomial is recovered by interpolation (Bodrato's sequence) and added back together at offsets
+ *                    of k limbs.
+ *
+ * Prototype        : Status mul_toom3( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn );
+ *
+ * Input Parameters : r      -> Result array with room for an + bn limbs (must not overlap a or b).
+ *                    a, an  -> First operand limbs and limb count (an >= bn).
+ *                    b, bn  -> Second operand limbs and limb count.
+ *
+ * Return Value     : SUCCESS -> If the product was computed.
+ *                    FAILURE -> If memory allocation fails for the evaluation or interpolation buffers.
+ *
+ * Algorithm        :
+ *                    With x(t) = x2·t^2 + x1·t + x0 and k = ceil(an / 3):
+ *                    1. Evaluate a(t), b(t) at t = 0, 1, -1, 2, ∞ (the value at -1 carries its own sign).
+ *                    2. Multiply the five pairs: W0, W1, Wm1, W2, W4 (each up to 2k + 2 limbs).
+ *                    3. Interpolate:
+ *                         W2  = (W2 - Wm1) / 3        W1 = (W1 - Wm1) / 2        Wm1 = Wm1 - W0
+ *                         W2  = (W2 - Wm1) / 2        Wm1 = Wm1 + W1 - W4        W2  = W2 - 2·W4
+ *                         W2  = W2 - W1               W1  = W1 - W2
+ *                    4. Coefficients are c0 = W0, c1 = W1, c2 = Wm1, c3 = W2, c4 = W4; r = Σ ci · B^(i·k).
+ *
+ * Notes            :
+ *                    • Time Complexity: O(n^1.465).
+ *                    • Needs b to reach its top piece (bn > 2k); otherwise Karatsuba is used instead.
+ *                    • From parallel_threshold limbs the five point-wise products run through mul_jobs() on several threads.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+
+/* Signed difference of two L-limb values: (r, rs) = (a, as) - (b, bs), signs are +1 / -1. r may alias a or b. */
+static void signed_sub( limb_t *r, int *rs, const limb_t *a, int as, const limb_t *b, int bs, size_t L )
+{
+	// Opposite signs: magnitudes add up, the headroom limbs keep it inside L
+	if( as != bs )
+	{
+		add_limbs( r, a, L, b, L );
+		*rs = as;
+		return;
+	}
+
+	if( compare_limbs( a, b, L ) != LARGE_2 )
+	{
+		sub_limbs( r, a, L, b, L );
+		*rs = as;
+	}
+	else
+	{
+		sub_limbs( r, b, L, a, L );
+		*rs = -as;
+	}
+}
+
+/* Divide an n-limb value by 3 in place, the division is known to be exact */
+static void divexact_by3( limb_t *r, size_t n )
+{
+	dlimb_t rem = 0;
+
+	for( size_t i = n; i-- > 0; )
+	{
+		dlimb_t cur = ( rem << LIMB_BITS ) | r[i];
+		r[i] = (limb_t) ( cur / 3 );
+		rem = cur % 3;
+	}
+}
+
+/* Evaluate x = x2·t^2 + x1·t + x0 at t = 1, -1, 2. Each output has k + 1 limbs. */
+static void toom3_evaluate( const limb_t *x, size_t n2, size_t k, limb_t *v1, limb_t *vm1, int *sm1, limb_t *v2 )
+{
+	const limb_t *x0 = x,
+				 *x1 = x + k,
+				 *x2 = x + 2 * k;
+
+	// p = x0 + x2, kept in v1
+	v1[k] = add_limbs( v1, x0, k, x2, n2 );
+
+	// x(-1) = p - x1
+	if( v1[k] || compare_limbs( v1, x1, k ) != LARGE_2 )
+	{
+		vm1[k] = v1[k] - sub_limbs( vm1, v1, k, x1, k );
+		*sm1 = 1;
+	}
+	else
+	{
+		sub_limbs( vm1, x1, k, v1, k );
+		vm1[k] = 0;
+		*sm1 = -1;
+	}
+
+	// x(1) = p + x1
+	v1[k] += add_limbs( v1, v1, k, x1, k );
+
+	// x(2) = x0 + 2·(x1 + 2·x2)
+	memcpy( v2, x2, n2 * sizeof( limb_t ) );
+	memset( v2 + n2, 0, ( k - n2 ) * sizeof( limb_t ) );
+	v2[k] = lshift_limbs( v2, v2, k, 1 );
+	v2[k] += add_limbs( v2, v2, k, x1, k );
+	lshift_limbs( v2, v2, k + 1, 1 );
+	add_limbs( v2, v2, k + 1, x0, k );
+}
+
+Status mul_toom3( limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn )
+{
+	STAT_SCOPE( STAT_TOOM3 );
+
+	size_t k = ( an + 2 ) / 3;
+
+	// b must reach its top piece
+	if( bn <= 2 * k )
+		return mul_karatsuba( r, a, an, b, bn );
+
+	size_t n2a = an - 2 * k,
+		   n2b = bn - 2 * k,
+		   L = 2 * k + 2;
+
+	// One block for six evaluation values and six interpolation values
+	limb_t *block = apc_alloc( ( 6 * ( k + 1 ) + 6 * L ) * sizeof( limb_t ) );
+	if( block == NULL )
+	{
+		perror("INFO : Memory Allocation Failed");
+		return FAILURE;
+	}
+
+	limb_t *a1 = block,      *am1 = a1 + k + 1,  *a2 = am1 + k + 1,
+		   *b1 = a2 + k + 1,  *bm1 = b1 + k + 1,  *b2 = bm1 + k + 1,
+		   *W0 = b2 + k + 1,  *W1 = W0 + L,       *Wm1 = W1 + L,
+		   *W2 = Wm1 + L,     *W4 = W2 + L,       *T = W4 + L;
+	int sa, sb;
+
+	// 1. Evaluation
+	toom3_evaluate( a, n2a, k, a1, am1, &sa, a2 );
+	toom3_evaluate( b, n2b, k, b1, bm1, &sb, b2 );
+
+	// 2. Point-wise products, independent of each other so large ones run in parallel
+	Mul_job jobs[5] = {
+		{ W0, a, b, k, k, SUCCESS },
+		{ W4, a + 2 * k, b + 2 * k, n2a, n2b, SUCCESS },
+		{ W1, a1, b1, k + 1, k + 1, SUCCESS },
+		{ Wm1, am1, bm1, k + 1, k + 1, SUCCESS },
+		{ W2, a2, b2, k + 1, k + 1, SUCCESS }
+	};
+	Status status;
+
+	if( bn >= parallel_threshold )
+		status = mul_jobs( jobs, 5 );
+	else
+	{
+		status = SUCCESS;
+		for( int j = 0; status == SUCCESS && j < 5; j++ )
+			status = mul_limbs( jobs[j].r, jobs[j].a, jobs[j].an, jobs[j].b, jobs[j].bn );
+	}
+
+	if( status != SUCCESS )
+	{
+		apc_free( block );
+		return FAILURE;
+	}
+
+	memset( W0 + 2 * k, 0, 2 * sizeof( limb_t ) );
+	memset( W4 + n2a + n2b, 0, ( L - n2a - n2b ) * sizeof( limb_t ) );
+
+	// 3. Interpolation
+	int s1, sm1 = sa * sb, s2;
+
+	signed_sub( W2, &s2, W2, 1, Wm1, sm1, L );
+	divexact_by3( W2, L );
+
+	signed_sub( W1, &s1, W1, 1, Wm1, sm1, L );
+	rshift_limbs( W1, W1, L, 1 );
+
+	signed_sub( Wm1, &sm1, Wm1, sm1, W0, 1, L );
+
+	signed_sub( W2, &s2, W2, s2, Wm1, sm1, L );
+	rshift_limbs( W2, W2, L, 1 );
+
+	signed_sub( Wm1, &sm1, Wm1, sm1, W1, -s1, L );
+	signed_sub( Wm1, &sm1, Wm1, sm1, W4, 1, L );
+
+	lshift_limbs( T, W4, L, 1 );
+	signed_sub( W2, &s2, W2, s2, T, 1, L );
+
+	signed_sub( W2, &s2, W2, s2, W1, s1, L );
+	signed_sub( W1, &s1, W1, s1, W2, s2, L );
+
+	// 4. Recomposition, the coefficient tails above the product length are zero
+	size_t rn = an + bn;
+
+	memcpy( r, W0, 2 * k * sizeof( limb_t ) );
+	memset( r + 2 * k, 0, 2 * k * sizeof( limb_t ) );
+	memcpy( r + 4 * k, W4, ( n2a + n2b ) * sizeof( limb_t ) );
+
+	add_limbs( r + k, r + k, rn - k, W1, L );
+	add_limbs( r + 2 * k, r + 2 * k, rn - 2 * k, Wm1, L );
+	add_limbs( r + 3 * k, r + 3 * k, rn - 3 * k, W2, rn - 3 * k < L ? rn - 3 * k : L );
+
+	apc_free( block );
+	return SUCCESS;
+}
@@ -0,0 +1,399 @@
+/*******************************************************************************************************************************************************************
+ * Title        : APC Threshold Tuner
+ * Project      : APC - Arbitrary Precision Calculator
+ *
+ * Description  : Measures the crossover points of the size-based algorithms on the host and writes them as apc_tune.h, which
+ *                apc.h includes ahead of its built-in defaults. Run through "make tune", which also rebuilds the calculator
+ *                with the new thresholds. Deleting apc_tune.h and running "make clean && make" returns to the defaults; a -D
+ *                on the compiler command line still overrides both.
+ *
+ * Usage        : ./apc_tune [-o file] [--time seconds] [--only name]
+ *                  -o      Output header (default stdout); progress goes to stderr.
+ *                  --time  Minimum measuring time per variant and size (default 0.03 s).
+ *                  --only  Tune one threshold (by macro name, e.g. TOOM3_THRESHOLD), the others keep their current values.
+ *                          An unknown name is a usage error and leaves the header untouched.
+ *
+ * Algorithm    :
+ *                1. Every threshold is a row of tune_table: its run-time variable, the operation it steers and a size range.
+ *                   Rows are tuned in table order and each result is stored straight away, so later rows (Toom-3 after
+ *                   Karatsuba, NTT after Toom-3, Newton division after all of them) are measured on tuned kernels.
+ *                2. For each size n in the range (growing by TUNE_STEP), the operation is timed twice at n: with the
+ *                   threshold set so that the faster algorithm handles the top level at n, and set so that it does not.
+ *                   Recursive calls inside both variants fall to the smaller algorithms, so exactly one level is compared.
+ *                   The larger multiplication algorithms are held off while a smaller one is timed (Toom-3 and NTT for the
+ *                   Karatsuba row, NTT for the Toom-3 row), since a range reaching past their current thresholds would
+ *                   otherwise time the same larger algorithm on both sides.
+ *                3. The crossover is the first n from which the new algorithm wins at TUNE_CONFIRM consecutive sizes, which
+ *                   keeps a single noisy point from deciding. No crossover in the range gives the top of the range.
+ *                4. The header lists each threshold with the timings at the crossover, guarded by #ifndef.
+ *
+ * Notes        :
+ *                • A new size-specialized variant is tuned by adding one row with its variable, its measure function and
+ *                  its range; everything else is shared.
+ *                • PARALLEL_THRESHOLD needs more than one core; on a single core it keeps its default.
+ *                • The tuner runs on whatever build flags the objects have, and its results hold for that build only.
+ *******************************************************************************************************************************************************************/
+
+#include "apc.h"
+#include <time.h>
+#include <unistd.h>
+
+#define TUNE_STEP     1.2      /* Size growth between measurements */
+#define TUNE_CONFIRM  3        /* Consecutive wins that confirm a crossover */
+
+/* Times the operation at n limbs with the faster algorithm enabled (use_new) or not, returns seconds per call */
+typedef double (*Measure_fn)( size_t n, int use_new );
+
+typedef struct
+{
+	const char *macro;			// Name in apc.h and apc_tune.h
+	size_t *var;				// Run-time threshold it sets
+	Measure_fn measure;
+	size_t lo, hi;				// Size range in limbs
+	int offset;					// Threshold = crossover + offset (-1 where "<=" selects the small algorithm)
+	const char *what;			// Comment in the header
+	size_t value;				// Result
+	double old_time, new_time;	// Timings at the crossover
+	int tuned;
+} Tune_param;
+
+static double min_time = 0.03;
+
+static uint64_t rng_state = 0x2545F4914F6CDD1Dull;
+
+static limb_t random_limb( void )
+{
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+
+	return (limb_t) rng_state;
+}
+
+static double now( void )
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static Status random_number( Bignum *num, size_t limbs )
+{
+	if( reserve_number( num, limbs ) != SUCCESS )
+		return FAILURE;
+
+	for( size_t i = 0; i < limbs; i++ )
+		num -> limbs[i] = random_limb();
+	num -> limbs[ limbs - 1 ] |= 0x80000000u;
+	num -> len = limbs;
+
+	return SUCCESS;
+}
+
+/* Operands of the operation being timed */
+static Bignum A, B, M, R;
+static char *text;
+
+typedef Status (*Op_fn)( void );
+
+/* Seconds per call of op, repeated until one batch lasts min_time */
+static double time_op( Op_fn op )
+{
+	size_t reps = 1;
+
+	for( ;; )
+	{
+		double start = now();
+		for( size_t r = 0; r < reps; r++ )
+		{
+			if( op() != SUCCESS )
+			{
+				fprintf( stderr, "INFO : Operation failed while tuning\n" );
+				exit( FAILURE );
+			}
+		}
+		double elapsed = now() - start;
+
+		if( elapsed >= min_time )
+			return elapsed / (double) reps;
+
+		reps = elapsed > min_time / 64 ? (size_t) ( reps * min_time / elapsed * 1.1 ) + 1 : reps * 2;
+	}
+}
+
+static Status op_multiply( void ) { return multiplication( &A, &B, &R ); }
+static Status op_divide( void )   { return division( &A, &B, &R, "Div" ); }
+static Status op_modpow( void )   { return mod_power( &A, &B, &M, &R ); }
+static Status op_parse( void )    { return decimal_to_number( &R, text, strlen( text ) ); }
+static Status op_print( void )    { return number_to_decimal( &A, text, strlen( text ) ); }
+
+static void setup_product( size_t n )
+{
+	if( random_number( &A, n ) != SUCCESS || random_number( &B, n ) != SUCCESS )
+		exit( FAILURE );
+}
+
+/* Toom-3 and NTT are held off while timing, so above their thresholds both variants still differ in Karatsuba */
+static double measure_karatsuba( size_t n, int use_new )
+{
+	size_t toom3 = toom3_threshold, ntt = ntt_threshold;
+
+	setup_product( n );
+	toom3_threshold = ntt_threshold = SIZE_MAX;
+	karatsuba_threshold = use_new ? n : n + 1;
+	double t = time_op( op_multiply );
+
+	toom3_threshold = toom3;
+	ntt_threshold = ntt;
+	return t;
+}
+
+/* NTT is held off while timing, as for Karatsuba */
+static double measure_toom3( size_t n, int use_new )
+{
+	size_t ntt = ntt_threshold;
+
+	setup_product( n );
+	ntt_threshold = SIZE_MAX;
+	toom3_threshold = use_new ? n : n + 1;
+	double t = time_op( op_multiply );
+
+	ntt_threshold = ntt;
+	return t;
+}
+
+static double measure_ntt( size_t n, int use_new )
+{
+	setup_product( n );
+	ntt_threshold = use_new ? n : n + 1;
+	return time_op( op_multiply );
+}
+
+/* 2n by n limbs: divisor and quotient both reach n */
+static double measure_div_newton( size_t n, int use_new )
+{
+	if( random_number( &A, 2 * n ) != SUCCESS || random_number( &B, n ) != SUCCESS )
+		exit( FAILURE );
+	div_newton_threshold = use_new ? n : n + 1;
+	return time_op( op_divide );
+}
+
+/* Parse of 9n digits (the quadratic loop runs while count <= 9 · convert_threshold) plus print of the parsed number
+   (quadratic while len <= convert_threshold) */
+static double measure_convert( size_t n, int use_new )
+{
+	size_t digits = n * DEC_CHUNK_DIGITS;
+
+	free( text );
+	text = malloc( digits + 1 );
+	if( text == NULL )
+		exit( FAILURE );
+	for( size_t i = 0; i < digits; i++ )
+		text[i] = (char) ( '0' + random_limb() % 10 );
+	text[0] = '9';
+	text[ digits ] = '\0';
+
+	convert_threshold = use_new ? n - 1 : n;
+	double seconds = time_op( op_parse );
+
+	if( decimal_to_number( &A, text, digits ) != SUCCESS )
+		exit( FAILURE );
+
+	convert_threshold = use_new ? A.len - 1 : A.len;
+	return seconds + time_op( op_print );
+}
+
+/* Odd n-limb modulus and a two-limb exponent; Montgomery runs while n < montgomery_threshold, Barrett is the "new" side */
+static double measure_montgomery( size_t n, int use_new )
+{
+	if( random_number( &M, n ) != SUCCESS || random_number( &A, n ) != SUCCESS || random_number( &B, 2 ) != SUCCESS )
+		exit( FAILURE );
+	M.limbs[0] |= 1;
+	A.limbs[ n - 1 ] >>= 1;
+	montgomery_threshold = use_new ? n : n + 1;
+	return time_op( op_modpow );
+}
+
+/* Toom-3 products from parallel_threshold limbs run their five sub-products on several threads */
+static double measure_parallel( size_t n, int use_new )
+{
+	setup_product( n );
+	parallel_threshold = use_new ? n : n + 1;
+	return time_op( op_multiply );
+}
+
+static Tune_param tune_table[] =
+{
+	{ .macro = "KARATSUBA_THRESHOLD",  .var = &karatsuba_threshold,  .measure = measure_karatsuba,  .lo = 4,   .hi = 300,    .offset = 0,  .what = "schoolbook -> Karatsuba" },
+	{ .macro = "TOOM3_THRESHOLD",      .var = &toom3_threshold,      .measure = measure_toom3,      .lo = 30,  .hi = 1500,   .offset = 0,  .what = "Karatsuba -> Toom-3" },
+	{ .macro = "NTT_THRESHOLD",        .var = &ntt_threshold,        .measure = measure_ntt,        .lo = 300, .hi = 150000, .offset = 0,  .what = "Toom-3 -> three-prime NTT" },
+	{ .macro = "DIV_NEWTON_THRESHOLD", .var = &div_newton_threshold, .measure = measure_div_newton, .lo = 50,  .hi = 20000,  .offset = 0,  .what = "Algorithm D -> Newton reciprocal division" },
+	{ .macro = "CONVERT_THRESHOLD",    .var = &convert_threshold,    .measure = measure_convert,    .lo = 4,   .hi = 2000,   .offset = -1, .what = "quadratic -> divide and conquer radix conversion" },
+	{ .macro = "MONTGOMERY_THRESHOLD", .var = &montgomery_threshold, .measure = measure_montgomery, .lo = 2,   .hi = 2000,   .offset = 0,  .what = "Montgomery -> Barrett modular products" },
+	{ .macro = "PARALLEL_THRESHOLD",   .var = &parallel_threshold,   .measure = measure_parallel,   .lo = 100, .hi = 20000,  .offset = 0,  .what = "single thread -> parallel Toom-3" },
+};
+
+#define TUNE_PARAMS ( sizeof( tune_table ) / sizeof( tune_table[0] ) )
+
+static void tune( Tune_param *p )
+{
+	size_t wins = 0, first = 0;
+	double first_old = 0, first_new = 0;
+
+	for( size_t n = p -> lo; n <= p -> hi; n = (size_t) ( n * TUNE_STEP ) > n ? (size_t) ( n * TUNE_STEP ) : n + 1 )
+	{
+		// Interleave the variants so drifting clock speeds hit both alike
+		double t_old = p -> measure( n, 0 ),
+			   t_new = p -> measure( n, 1 );
+		double t = p -> measure( n, 0 );
+		if( t < t_old )
+			t_old = t;
+		t = p -> measure( n, 1 );
+		if( t < t_new )
+			t_new = t;
+
+		fprintf( stderr, "  %-22s %7zu limbs  old %12.0f ns  new %12.0f ns%s\n", p -> macro, n, t_old * 1e9, t_new * 1e9,
+				 t_new < t_old ? "  *" : "" );
+
+		if( t_new < t_old )
+		{
+			if( wins++ == 0 )
+			{
+				first = n;
+				first_old = t_old;
+				first_new = t_new;
+			}
+			if( wins == TUNE_CONFIRM )
+				break;
+		}
+		else
+			wins = 0;
+	}
+
+	if( wins < TUNE_CONFIRM )
+	{
+		first = p -> hi;
+		first_old = first_new = 0;
+	}
+
+	p -> value = (size_t) ( (long) first + p -> offset );
+	p -> old_time = first_old;
+	p -> new_time = first_new;
+	p -> tuned = 1;
+	*p -> var = p -> value;
+}
+
+static void write_header( FILE *out )
+{
+	char host[256] = "unknown";
+	gethostname( host, sizeof( host ) - 1 );
+
+	time_t t = time( NULL );
+	char date[64];
+	strftime( date, sizeof( date ), "%Y-%m-%d %H:%M", localtime( &t ) );
+
+	fprintf( out, "/* apc_tune.h: crossover thresholds measured by \"make tune\" on %s, %s, with %zu thread(s).\n"
+				  " * Generated file; delete it and run \"make clean && make\" to return to the defaults in apc.h. */\n\n"
+				  "#ifndef APC_TUNE_H\n#define APC_TUNE_H\n", host, date, parallel_threads() );
+
+	for( size_t i = 0; i < TUNE_PARAMS; i++ )
+	{
+		Tune_param *p = &tune_table[i];
+
+		fprintf( out, "\n/* %s", p -> what );
+		if( !p -> tuned )
+			fprintf( out, ": not measured, current value kept" );
+		else if( p -> new_time > 0 )
+			fprintf( out, ": %.0f ns -> %.0f ns at the crossover", p -> old_time * 1e9, p -> new_time * 1e9 );
+		else
+			fprintf( out, ": no crossover up to %zu limbs", p -> hi );
+		fprintf( out, " */\n#ifndef %s\n#define %s %zu\n#endif\n", p -> macro, p -> macro, *p -> var );
+	}
+
+	fprintf( out, "\n#endif /* APC_TUNE_H */\n" );
+}
+
+int main( int argc, char *argv[] )
+{
+	const char *path = NULL,
+			   *only = NULL;
+
+	for( int i = 1; i < argc; i++ )
+	{
+		if( strcmp( argv[i], "-o" ) == 0 && i + 1 < argc )
+			path = argv[++i];
+		else if( strcmp( argv[i], "--time" ) == 0 && i + 1 < argc )
+			min_time = atof( argv[++i] );
+		else if( strcmp( argv[i], "--only" ) == 0 && i + 1 < argc )
+			only = argv[++i];
+		else
+		{
+			printf("Format : ./apc_tune [-o file] [--time seconds] [--only THRESHOLD_NAME]\n");
+			return FAILURE;
+		}
+	}
+
+	// An unknown name would tune nothing and still rewrite the header
+	if( only )
+	{
+		size_t i = 0;
+		while( i < TUNE_PARAMS && strcmp( only, tune_table[i].macro ) != 0 )
+			i++;
+
+		if( i == TUNE_PARAMS )
+		{
+			printf("INFO : Unknown threshold \"%s\", expected one of:", only );
+			for( i = 0; i < TUNE_PARAMS; i++ )
+				printf( " %s", tune_table[i].macro );
+			printf("\nFormat : ./apc_tune [-o file] [--time seconds] [--only THRESHOLD_NAME]\n");
+			return FAILURE;
+		}
+	}
+
+	apc_arena_begin();
+
+	for( size_t i = 0; i < TUNE_PARAMS; i++ )
+	{
+		Tune_param *p = &tune_table[i];
+		size_t current = *p -> var;
+
+		if( only && strcmp( only, p -> macro ) != 0 )
+			continue;
+
+		if( p -> var == &parallel_threshold && parallel_threads() < 2 )
+		{
+			fprintf( stderr, "%s: single core, keeping %zu\n", p -> macro, current );
+			continue;
+		}
+
+		fprintf( stderr, "%s (%s), currently %zu:\n", p -> macro, p -> what, current );
+		tune( p );
+		fprintf( stderr, "%s = %zu\n", p -> macro, p -> value );
+	}
+
+	free_number( &A );
+	free_number( &B );
+	free_number( &M );
+	free_number( &R );
+	free( text );
+	apc_arena_end();
+
+	// The header is written only after every measurement, so an interrupted run leaves the old one in place
+	FILE *out = path ? fopen( path, "w" ) : stdout;
+	if( out == NULL )
+	{
+		perror("INFO : Cannot open output file");
+		return FAILURE;
+	}
+
+	write_header( out );
+
+	if( out != stdout && fclose( out ) != 0 )
+	{
+		perror("INFO : Cannot write output file");
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
\ No newline at end of file